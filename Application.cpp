@@ -4,6 +4,13 @@
 #include "classes/Checkers.h"
 #include "classes/Othello.h"
 #include "classes/Connect4.h"
+#include "classes/Gomoku.h"
+#include "classes/Journal.h"
+#include "classes/TextureCache.h"
+#include "classes/Animator.h"
+#include "classes/Profiler.h"
+#include "classes/Trace.h"
+#include "classes/AllocTracker.h"
 
 namespace ClassGame {
         //
@@ -14,6 +21,149 @@ namespace ClassGame {
         int gameWinner = -1;
         int g_gameMode = 0;
         int g_aiSide = 0;  
+        // the settings panel only rebuilds its board text when the board actually changes
+        BoardSnapshot shownSnapshot;
+        std::string shownState;
+        char recordPath[256] = "game.grec";
+        // the game in progress is journalled here and picked up again after a crash
+        const char *JOURNAL_PATH = "journal.grec";
+        Journal journal;
+        // written when recording is switched off in the settings window
+        const char *TRACE_PATH = "trace.json";
+        bool traceWritten = false;
+        // a settled frame should hardly touch the heap, see AllocTracker.h
+        const int FRAME_ALLOC_BUDGET = 64;
+#if defined(ALLOC_TRACKER_ENABLED) && !defined(PROFILER_ENABLED)
+        bool showAllocations = true;
+#endif
+#ifdef PROFILER_ENABLED
+        bool showProfiler = true;
+#endif
+
+        //
+        // after moving around in the history the game may be back in play, or over again
+        //
+        void RefreshGameOver()
+        {
+            gameOver = false;
+            gameWinner = -1;
+            EndOfTurn();
+        }
+
+        //
+        // take back or replay turns. against the AI keep going until the human is to move again
+        //
+        void StepHistory(bool forward)
+        {
+            bool hasHuman = !game->getPlayerAt(0)->isAIPlayer() || !game->getPlayerAt(1)->isAIPlayer();
+            do {
+                if (!(forward ? game->redo() : game->undo())) {
+                    break;
+                }
+            } while (hasHuman && game->getCurrentPlayer()->isAIPlayer());
+            RefreshGameOver();
+        }
+
+        //
+        // the AI moves from the render loop, so it needs frames while it is its turn
+        //
+        bool AIToMove()
+        {
+            return game && !gameOver && game->gameHasAI() && !game->canRedo() && !Animator::instance().busy() &&
+                   (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI);
+        }
+
+        //
+        // something on screen changes by itself: a piece sliding, the atlas still decoding, the
+        // AI about to play, or a background search (pondering, hints) with numbers to show
+        //
+        bool WantsRedraw()
+        {
+            if (Animator::instance().busy() || TextureCache::instance().loading() || AIToMove()) {
+                return true;
+            }
+            SearchStats stats;
+            return game && ((game->searchStats(stats) && stats.searching) || (game->_gameOptions.showHints && game->hintsRunning()));
+        }
+
+        //
+        // what the AI is thinking, refreshed every frame while its search runs
+        //
+        void DrawEngineWindow()
+        {
+            ImGui::Begin("Engine");
+            SearchStats stats;
+            if (!game || !game->searchStats(stats)) {
+                ImGui::TextDisabled("no engine");
+                ImGui::End();
+                return;
+            }
+            ImGui::Text("%s", stats.pondering ? "pondering" : stats.searching ? "searching" : "idle");
+            ImGui::Text("Depth: %d", stats.depth);
+            ImGui::Text("Nodes: %llu", (unsigned long long)stats.nodes);
+            ImGui::Text("Nodes/s: %llu", (unsigned long long)stats.nodesPerSecond);
+            ImGui::Text("TT hits: %llu", (unsigned long long)stats.ttHits);
+            ImGui::Text("Cutoffs: %llu", (unsigned long long)stats.cutoffs);
+            ImGui::Text("Score: %d", stats.score);
+            ImGui::Text("Time: %.0f ms", stats.elapsedMs);
+            ImGui::TextWrapped("PV: %s", stats.pv.c_str());
+            ImGui::End();
+        }
+
+        //
+        // every board set up goes through here so its allocations are counted together
+        //
+        void SetUpBoard(Game *board)
+        {
+            ALLOC_SCOPE("setUpBoard");
+            board->setUpBoard();
+        }
+
+        //
+        // games by the name they write into their records
+        //
+        Game *CreateGame(const std::string &name)
+        {
+            Game *created = nullptr;
+            if (name == "TicTacToe") created = new TicTacToe();
+            else if (name == "Checkers") created = new Checkers();
+            else if (name == "Othello") created = new Othello();
+            else if (name == "Gomoku") created = new Gomoku();
+            else if (name == "Connect4") created = new Connect4();
+            if (created) {
+                created->setJournal(&journal);
+            }
+            return created;
+        }
+
+        //
+        // replace the current game with the first record in a file, the board ends up on its last move
+        //
+        bool LoadGame(const char *path)
+        {
+            GameRecordReader reader;
+            GameRecordHeader header;
+            if (!reader.open(path) || !reader.nextGame(header)) {
+                return false;
+            }
+            Game *loaded = CreateGame(header.gameName);
+            if (!loaded) {
+                return false;
+            }
+            SetUpBoard(loaded);
+            if (!loaded->loadRecord(reader, header)) {
+                loaded->stopGame();
+                delete loaded;
+                return false;
+            }
+            if (game) {
+                game->stopGame();
+                delete game;
+            }
+            game = loaded;
+            RefreshGameOver();
+            return true;
+        }
 
         //
         // game starting point
@@ -22,6 +172,13 @@ namespace ClassGame {
         void GameStartUp() 
         {
             game = nullptr;
+            Tracer::setThreadName("main");
+            // every board and piece image goes into one texture so a board is drawn in one go,
+            // the images decode on worker threads while the first frames are drawn
+            TextureCache::instance().buildAtlas();
+            // an interrupted game is still in the journal, the writer only starts the file over on the next turn
+            LoadGame(JOURNAL_PATH);
+            journal.open(JOURNAL_PATH);
         }
 
         //
@@ -30,18 +187,58 @@ namespace ClassGame {
         //
         void RenderGame() 
         {
+#ifdef PROFILER_ENABLED
+                // the previous frame is complete once we are back here
+                Profiler::instance().endFrame();
+                if (showProfiler) {
+                    Profiler::instance().drawWindow(&showProfiler);
+                }
+#endif
+                PROFILE_SCOPE("RenderGame");
+                ALLOC_SCOPE_BUDGET("frame", FRAME_ALLOC_BUDGET);
+                TRACE_SCOPE("frame");
+                TextureCache::instance().update();
+                Animator::instance().update(ImGui::GetIO().DeltaTime);
+
                 ImGui::DockSpaceOverViewport();
 
                 //ImGui::ShowDemoWindow();
 
                 ImGui::Begin("Settings");
+#ifdef PROFILER_ENABLED
+                ImGui::Checkbox("Profiler", &showProfiler);
+#endif
+#if defined(ALLOC_TRACKER_ENABLED) && !defined(PROFILER_ENABLED)
+                // without the profiler the allocation table gets a window of its own
+                ImGui::Checkbox("Allocations", &showAllocations);
+                if (showAllocations) {
+                    if (ImGui::Begin("Allocations", &showAllocations)) {
+                        AllocTracker::drawStats();
+                    }
+                    ImGui::End();
+                }
+#endif
+                // frames, searches and texture loads on one timeline for chrome://tracing or perfetto
+                bool tracing = Tracer::enabled();
+                if (ImGui::Checkbox("Record trace", &tracing)) {
+                    if (tracing) {
+                        Tracer::start();
+                    } else {
+                        Tracer::stop();
+                        traceWritten = Tracer::write(TRACE_PATH);
+                    }
+                }
+                if (traceWritten && !tracing) {
+                    ImGui::SameLine();
+                    ImGui::Text("saved %s", TRACE_PATH);
+                }
 
                 if (gameOver) {
                     ImGui::Text("Game Over!");
                     ImGui::Text("Winner: %d", gameWinner);
                     if (ImGui::Button("Reset Game")) {
                         game->stopGame();
-                        game->setUpBoard();
+                        SetUpBoard(game);
                         gameOver = false;
                         gameWinner = -1;
                     }
@@ -61,27 +258,43 @@ namespace ClassGame {
                 }
                 ImGui::Separator();
 
+                ImGui::InputText("Record", recordPath, sizeof(recordPath));
+                if (ImGui::Button("Load Game")) {
+                    LoadGame(recordPath);
+                }
+                if (game) {
+                    ImGui::SameLine();
+                    if (ImGui::Button("Save Game")) {
+                        game->saveRecord(recordPath);
+                    }
+                }
+                ImGui::Separator();
+
                 if (!game) {
                     if (ImGui::Button("Start Tic-Tac-Toe")) {
-                        game = new TicTacToe();
-                        game->setUpBoard();
+                        game = CreateGame("TicTacToe");
+                        SetUpBoard(game);
                     }
                     if (ImGui::Button("Start Checkers")) {
-                        game = new Checkers();
-                        game->setUpBoard();
+                        game = CreateGame("Checkers");
+                        SetUpBoard(game);
                     }
                     if (ImGui::Button("Start Othello")) {
-                        game = new Othello();
-                        game->setUpBoard();
+                        game = CreateGame("Othello");
+                        SetUpBoard(game);
+                    }
+                    if (ImGui::Button("Start Gomoku")) {
+                        game = CreateGame("Gomoku");
+                        SetUpBoard(game);
                     }
                     if (ImGui::Button("Start Connect 4")) {
-                        game = new Connect4();
+                        game = CreateGame("Connect4");
 
                         // Ensure the logical player count
                         game->setNumberOfPlayers(2);
 
                         // Build the board (this may create Player objects)
-                        game->setUpBoard();
+                        SetUpBoard(game);
 
                         // Now set AI flags — do this after setUpBoard() to be safe.
                         // Default everybody to human first
@@ -103,19 +316,65 @@ namespace ClassGame {
                     }
                 } else {
                     ImGui::Text("Current Player Number: %d", game->getCurrentPlayer()->playerNumber());
-                    ImGui::Text("Current Board State: %s", game->stateString().c_str());
+                    if (game->gameHasAI() && ImGui::Checkbox("AI thinks on your time", &game->_gameOptions.AIPonder) && !game->_gameOptions.AIPonder) {
+                        game->stopAI();
+                    }
+                    if (game->hasHints()) {
+                        if (ImGui::Checkbox("Show move hints", &game->_gameOptions.showHints) && !game->_gameOptions.showHints) {
+                            game->stopHints();
+                        }
+                    }
+                    // time sliced search keeps the AI on this thread, for builds that have no other
+                    if (game->gameHasAI()) {
+                        ImGui::SliderInt("AI slice (us)", &game->_gameOptions.AISliceUs, 0, 16000);
+                        ImGui::SameLine();
+                        ImGui::TextDisabled(game->_gameOptions.AISliceUs > 0 ? "per frame" : "worker thread");
+                    }
+                    BoardSnapshot current = game->snapshot();
+                    if (current != shownSnapshot) {
+                        shownSnapshot = current;
+                        shownState = game->stateString();
+                    }
+                    ImGui::Text("Current Board State: %s", shownState.c_str());
+
+                    ImGui::BeginDisabled(!game->canUndo());
+                    if (ImGui::Button("Undo")) {
+                        StepHistory(false);
+                    }
+                    ImGui::EndDisabled();
+                    ImGui::SameLine();
+                    ImGui::BeginDisabled(!game->canRedo());
+                    if (ImGui::Button("Redo")) {
+                        StepHistory(true);
+                    }
+                    ImGui::EndDisabled();
+
+                    // scrub through the whole game, the AI waits while there are moves ahead of the board
+                    const TurnHistory &history = game->getHistory();
+                    int ply = history.cursor();
+                    if (ImGui::SliderInt("Ply", &ply, 0, history.size())) {
+                        game->gotoPly(ply);
+                        RefreshGameOver();
+                    }
                 }
                 ImGui::End();
 
                 ImGui::Begin("GameWindow");
                 if (game) {
                     game->drawFrame();
-                    if (game->gameHasAI() && (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI))
+                    // the AI waits for the last move to land before it plays
+                    if (AIToMove())
                     {
+                        PROFILE_SCOPE("updateAI");
+                        TRACE_SCOPE("updateAI");
+                        // the search itself is counted on its own thread, this is the game's side of it
+                        ALLOC_SCOPE("AI move");
                         game->updateAI();
                     }
                 }
                 ImGui::End();
+
+                DrawEngineWindow();
         }
 
         //
@@ -124,7 +383,12 @@ namespace ClassGame {
         //
         void EndOfTurn() 
         {
-            Player *winner = game->checkForWinner();
+            PROFILE_SCOPE("EndOfTurn");
+            Player *winner;
+            {
+                PROFILE_SCOPE("checkForWinner");
+                winner = game->checkForWinner();
+            }
             if (winner)
             {
                 gameOver = true;
@@ -134,5 +398,10 @@ namespace ClassGame {
                 gameOver = true;
                 gameWinner = -1;
             }
+            if (gameOver) {
+                // a finished game is not restored on the next start, reattaching makes the game rewrite it if play goes on
+                journal.clear();
+                game->setJournal(&journal);
+            }
         }
 }
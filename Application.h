@@ -4,4 +4,6 @@ namespace ClassGame {
     void GameStartUp();
     void RenderGame();
     void EndOfTurn();
+    // true while the screen changes without any input, the main loop sleeps between events otherwise
+    bool WantsRedraw();
 }
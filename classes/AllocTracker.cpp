@@ -0,0 +1,187 @@
+#include "AllocTracker.h"
+
+#ifdef ALLOC_TRACKER_ENABLED
+
+#include "../imgui/imgui.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+// nothing in here may allocate, it runs inside operator new
+static std::mutex statsMutex;
+static AllocTracker::Stats scopeStats[AllocTracker::MAX_SCOPES];
+static int scopeCount = 0;
+static bool anyOverBudget = false;
+static std::atomic<uint64_t> totalCount(0);
+static std::atomic<uint64_t> totalBytes(0);
+static thread_local AllocScope *currentScope = nullptr;
+
+int AllocTracker::scopeId(const char *name, int budget)
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (int i = 0; i < scopeCount; i++) {
+        if (std::strcmp(scopeStats[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (scopeCount == MAX_SCOPES) {
+        // everything past the limit is lumped in with the last scope
+        return MAX_SCOPES - 1;
+    }
+    Stats &stats = scopeStats[scopeCount];
+    std::memset(&stats, 0, sizeof(stats));
+    stats.name = name;
+    stats.budget = budget;
+    return scopeCount++;
+}
+
+void AllocTracker::countAllocation(size_t bytes)
+{
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (AllocScope *scope = currentScope) {
+        scope->_count++;
+        scope->_bytes += bytes;
+    }
+}
+
+bool AllocTracker::budgetExceeded()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return anyOverBudget;
+}
+
+void AllocTracker::finishRun(const AllocScope &scope)
+{
+    bool fail = false;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        Stats &stats = scopeStats[scope._scope];
+        stats.runs++;
+        stats.lastCount = scope._count;
+        stats.lastBytes = scope._bytes;
+        if (scope._count > stats.worstCount) {
+            stats.worstCount = scope._count;
+            stats.worstBytes = scope._bytes;
+        }
+        if (stats.budget != NO_BUDGET && stats.runs > WARMUP_RUNS && scope._count > (uint64_t)stats.budget) {
+            stats.overBudget++;
+            anyOverBudget = true;
+            fail = std::getenv("ALLOC_BUDGET_FAIL") != nullptr;
+        }
+    }
+    if (fail) {
+        const Stats &stats = scopeStats[scope._scope];
+        fprintf(stderr, "allocation budget exceeded: %s made %llu allocations, the budget is %d\n",
+                stats.name, (unsigned long long)scope._count, stats.budget);
+        std::abort();
+    }
+}
+
+void AllocTracker::drawStats()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    ImGui::Text("All threads: %llu allocations, %.1f MB", (unsigned long long)totalCount.load(std::memory_order_relaxed),
+                totalBytes.load(std::memory_order_relaxed) / (1024.0 * 1024.0));
+    if (!ImGui::BeginTable("allocations", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+        return;
+    }
+    ImGui::TableSetupColumn("Scope");
+    ImGui::TableSetupColumn("Runs");
+    ImGui::TableSetupColumn("Last");
+    ImGui::TableSetupColumn("Last bytes");
+    ImGui::TableSetupColumn("Worst");
+    ImGui::TableSetupColumn("Budget");
+    ImGui::TableHeadersRow();
+    for (int i = 0; i < scopeCount; i++) {
+        const Stats &stats = scopeStats[i];
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(stats.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", (unsigned long long)stats.runs);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", (unsigned long long)stats.lastCount);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", (unsigned long long)stats.lastBytes);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", (unsigned long long)stats.worstCount);
+        ImGui::TableNextColumn();
+        if (stats.budget == NO_BUDGET) {
+            ImGui::TextUnformatted("-");
+        } else if (stats.overBudget) {
+            ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "%d (over %llu times)", stats.budget, (unsigned long long)stats.overBudget);
+        } else {
+            ImGui::Text("%d", stats.budget);
+        }
+    }
+    ImGui::EndTable();
+}
+
+AllocScope::AllocScope(int scope) : _scope(scope), _parent(currentScope), _count(0), _bytes(0)
+{
+    currentScope = this;
+}
+
+AllocScope::~AllocScope()
+{
+    currentScope = _parent;
+    // the scopes around this one count what it allocated as well
+    if (_parent) {
+        _parent->_count += _count;
+        _parent->_bytes += _bytes;
+    }
+    AllocTracker::finishRun(*this);
+}
+
+//
+// the replacements, every form of new and delete that is not over-aligned
+//
+void *operator new(std::size_t size)
+{
+    AllocTracker::countAllocation(size);
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void *memory = std::malloc(size)) {
+            return memory;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+//
+// heap allocation counts per scope
+//
+// the global operator new is replaced so every allocation is charged to the innermost
+// ALLOC_SCOPE running on the allocating thread, and through it to the scopes around it. each
+// scope keeps the counts of its last run and its worst one. a scope given a budget notes every
+// run after the warm up that allocates more often than that, and with ALLOC_BUDGET_FAIL set in the environment
+// the process stops right there, so a benchmark run fails on the first regression
+//
+// it is built with ALLOC_TRACKER_ENABLED (cmake -DENABLE_ALLOC_TRACKER=ON). without it the
+// macros are empty and operator new is left alone
+//
+#ifdef ALLOC_TRACKER_ENABLED
+
+#include <cstddef>
+#include <cstdint>
+
+class AllocScope;
+
+class AllocTracker
+{
+public:
+    static const int MAX_SCOPES = 32;
+    static const int NO_BUDGET = -1;
+    // the first runs of a scope fill caches and grow buffers, budgets apply after these
+    static const int WARMUP_RUNS = 120;
+
+    struct Stats
+    {
+        const char  *name;
+        int         budget;         // allocations per run, NO_BUDGET for none
+        uint64_t    runs;
+        uint64_t    lastCount;
+        uint64_t    lastBytes;
+        uint64_t    worstCount;
+        uint64_t    worstBytes;
+        uint64_t    overBudget;     // runs that went over
+    };
+
+    // an id for a scope name, ALLOC_SCOPE looks it up once per call site
+    static int      scopeId(const char *name, int budget);
+    // called from operator new
+    static void     countAllocation(size_t bytes);
+    // true once any scope has gone over its budget
+    static bool     budgetExceeded();
+    // the table for the profiler window
+    static void     drawStats();
+
+private:
+    friend class AllocScope;
+    static void     finishRun(const AllocScope &scope);
+};
+
+class AllocScope
+{
+public:
+    explicit AllocScope(int scope);
+    ~AllocScope();
+
+private:
+    friend class AllocTracker;
+    int         _scope;
+    AllocScope  *_parent;
+    uint64_t    _count;
+    uint64_t    _bytes;
+};
+
+#define ALLOC_JOIN2(a, b) a##b
+#define ALLOC_JOIN(a, b) ALLOC_JOIN2(a, b)
+#define ALLOC_SCOPE_BUDGET(name, budget) \
+    static const int ALLOC_JOIN(allocScope, __LINE__) = AllocTracker::scopeId(name, budget); \
+    AllocScope ALLOC_JOIN(allocScopeGuard, __LINE__)(ALLOC_JOIN(allocScope, __LINE__))
+#define ALLOC_SCOPE(name) ALLOC_SCOPE_BUDGET(name, AllocTracker::NO_BUDGET)
+
+#else
+
+#define ALLOC_SCOPE_BUDGET(name, budget)
+#define ALLOC_SCOPE(name)
+
+#endif
@@ -0,0 +1,89 @@
+#include "Animator.h"
+#include "Bit.h"
+#include <algorithm>
+
+Animator &Animator::instance()
+{
+    static Animator animator;
+    return animator;
+}
+
+void Animator::start(Bit *bit, const ImVec2 &position, float seconds, Easing easing)
+{
+    cancel(bit);
+    Tween tween;
+    tween.bit = bit;
+    tween.from = bit->getPosition();
+    tween.to = position;
+    tween.elapsed = 0.0f;
+    tween.duration = seconds;
+    tween.easing = easing;
+    _tweens.push_back(tween);
+}
+
+void Animator::cancel(Bit *bit)
+{
+    _tweens.erase(std::remove_if(_tweens.begin(), _tweens.end(), [bit](const Tween &tween) {
+        return tween.bit == bit;
+    }), _tweens.end());
+}
+
+int Animator::update(float seconds)
+{
+    int finished = 0;
+    for (Tween &tween : _tweens) {
+        tween.elapsed += seconds;
+        if (tween.elapsed >= tween.duration) {
+            tween.bit->setPosition(tween.to);
+            tween.bit->finishMove();
+            tween.bit = nullptr;
+            finished++;
+            continue;
+        }
+        float t = ease(tween.easing, tween.elapsed / tween.duration);
+        tween.bit->setPosition(ImVec2(tween.from.x + (tween.to.x - tween.from.x) * t,
+                                      tween.from.y + (tween.to.y - tween.from.y) * t));
+    }
+    if (finished) {
+        _tweens.erase(std::remove_if(_tweens.begin(), _tweens.end(), [](const Tween &tween) {
+            return tween.bit == nullptr;
+        }), _tweens.end());
+    }
+    return finished;
+}
+
+float Animator::ease(Easing easing, float t)
+{
+    t = std::clamp(t, 0.0f, 1.0f);
+    switch (easing) {
+        case Easing::Linear:
+            return t;
+        case Easing::EaseOutCubic: {
+            float u = 1.0f - t;
+            return 1.0f - u * u * u;
+        }
+        case Easing::EaseInOutCubic: {
+            if (t < 0.5f) {
+                return 4.0f * t * t * t;
+            }
+            float u = -2.0f * t + 2.0f;
+            return 1.0f - u * u * u / 2.0f;
+        }
+        case Easing::EaseOutBounce: {
+            // three bounces, each a parabola a quarter the height of the last
+            const float n = 7.5625f, d = 2.75f;
+            if (t < 1.0f / d) {
+                return n * t * t;
+            } else if (t < 2.0f / d) {
+                t -= 1.5f / d;
+                return n * t * t + 0.75f;
+            } else if (t < 2.5f / d) {
+                t -= 2.25f / d;
+                return n * t * t + 0.9375f;
+            }
+            t -= 2.625f / d;
+            return n * t * t + 0.984375f;
+        }
+    }
+    return t;
+}
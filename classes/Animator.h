@@ -0,0 +1,52 @@
+#pragma once
+#include "../imgui/imgui.h"
+#include <vector>
+
+class Bit;
+
+enum class Easing
+{
+    Linear,
+    EaseOutCubic,
+    EaseInOutCubic,
+    EaseOutBounce
+};
+
+//
+// every piece that is sliding somewhere, advanced together once a frame
+//
+// tweens run on real time from ImGuiIO::DeltaTime, so a move takes as long at 30 fps as it
+// does at 144. a bit is told when its tween is done, and the game loop asks busy() before
+// letting the AI move so it never plays over a piece that is still on its way
+//
+class Animator
+{
+public:
+    static Animator &instance();
+
+    // slide bit from where it is now to position
+    void    start(Bit *bit, const ImVec2 &position, float seconds, Easing easing);
+    // drop bit's tween, it stays where it got to
+    void    cancel(Bit *bit);
+    // advance everything by seconds, returns how many tweens finished
+    int     update(float seconds);
+    bool    busy() const { return !_tweens.empty(); }
+
+    // t from 0 to 1, the fraction of the way along at that point
+    static float    ease(Easing easing, float t);
+
+private:
+    Animator() {}
+
+    struct Tween
+    {
+        Bit     *bit;
+        ImVec2  from;
+        ImVec2  to;
+        float   elapsed;
+        float   duration;
+        Easing  easing;
+    };
+
+    std::vector<Tween>  _tweens;
+};
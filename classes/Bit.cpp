@@ -1,10 +1,13 @@
 
 #include "Bit.h"
 #include "BitHolder.h"
-#include <cmath>
 
 Bit::~Bit()
 {
+	if (_moving)
+	{
+		Animator::instance().cancel(this);
+	}
 }
 
 BitHolder *Bit::getHolder()
@@ -27,35 +30,43 @@ void Bit::setPickedUp(bool up)
 		float opacity = 0.0f;
 		float scale = 1.0f;
 		float rotation = 0.0f;
-		int z;
 
 		if (up)
 		{
 			opacity = kPickedUpOpacity;
-			z = bitz::kPickupUpZ;
-			_restingZ = getLocalZOrder();
+			if (_moving)
+			{
+				// the hand takes over from the animation
+				Animator::instance().cancel(this);
+				_moving = false;
+			}
+			else
+			{
+				_restingZ = getLocalZOrder();
+			}
 			_restingTransform = getRotation();
 			scale = kPickedUpScale;
 		}
 		else
 		{
 			opacity = 1.0f;
-			z = getLocalZOrder(); // _restingZ;
-			if (z == bitz::kPickupUpZ)
-			{
-				z = _restingZ;
-			}
 			rotation = _restingTransform;
 			scale = 1.0f;
 		}
 		setScale(scale); // todo: animate this
-		setLocalZOrder(z);
 		setOpacity(opacity);
 		setRotation(rotation);
 		_pickedUp = up;
+		updateZ();
 	}
 }
 
+void Bit::updateZ()
+{
+	// a piece in the hand stays on top even if it was still on its way somewhere
+	setLocalZOrder(_pickedUp ? bitz::kPickupUpZ : _moving ? bitz::kMovingZ : _restingZ);
+}
+
 bool Bit::friendly()
 {
 	return true;
@@ -76,31 +87,19 @@ Player *Bit::getOwner()
 	return _owner;
 }
 
-void Bit::moveTo(const ImVec2 &point)
+void Bit::moveTo(const ImVec2 &point, float seconds, Easing easing)
 {
-	_destinationPosition = point;
-	// work out the step so we move same step each update
-	ImVec2 delta = ImVec2(_destinationPosition.x - getPosition().x, _destinationPosition.y - getPosition().y);
-	_destinationStep = ImVec2(delta.x * 0.05f, delta.y * 0.05f);
+	if (!_moving && !_pickedUp)
+	{
+		_restingZ = getLocalZOrder();
+	}
 	_moving = true;
+	updateZ();
+	Animator::instance().start(this, point, seconds, easing);
 }
 
-void Bit::update()
+void Bit::finishMove()
 {
-	if (!_moving)
-	{
-		return;
-	}
-	ImVec2 pos = getPosition();
-	ImVec2 delta = ImVec2(_destinationPosition.x - pos.x, _destinationPosition.y - pos.y);
-	if (std::fabs(delta.x) >= 0.1f || std::fabs(delta.y) > 0.1f)
-	{
-		ImVec2 newPosition = ImVec2(pos.x + _destinationStep.x, pos.y + _destinationStep.y);
-		setPosition(newPosition);
-	}
-	else
-	{
-		setPosition(_destinationPosition);
-		_moving = false;
-	}
-}
\ No newline at end of file
+	_moving = false;
+	updateZ();
+}
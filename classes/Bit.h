@@ -1,15 +1,19 @@
 #pragma once
 
 #include "Sprite.h"
+#include "Animator.h"
 
 class Player;
 class BitHolder;
 
 //
-// these aren't used yet but will be used for dragging pieces
+// a bit rests on kPieceZ, goes up to kMovingZ while it animates to a new square and to
+// kPickupUpZ while it is being dragged. the render queue paints in this order
 //
 #define kPickedUpScale 1.2f
 #define kPickedUpOpacity 255
+// how long a piece takes to slide to a new square
+#define kMoveSeconds 0.3f
 
 enum bitz
 {
@@ -29,6 +33,9 @@ public:
 		_gameTag = 0;
 		_entityType = EntityBit;
 		_moving = false;
+		_restingZ = bitz::kPieceZ;
+		_restingTransform = 0.0f;
+		setLocalZOrder(bitz::kPieceZ);
 	};
 
 	~Bit();
@@ -48,19 +55,20 @@ public:
 	// game defined game tags
 	const int gameTag() const { return _gameTag; };
 	void setGameTag(int tag) { _gameTag = tag; };
-	// move to a position
-	void moveTo(const ImVec2 &point);
-	void update();
+	// slide to a position, the Animator moves the bit and calls finishMove when it gets there
+	void moveTo(const ImVec2 &point, float seconds = kMoveSeconds, Easing easing = Easing::EaseOutCubic);
+	void finishMove();
 	void setOpacity(float opacity){};
 	bool getMoving() { return _moving; };
 
 private:
+	// back to _restingZ, or up to the layer for being dragged or moving
+	void updateZ();
+
 	int _restingZ;
 	float _restingTransform;
 	bool _pickedUp;
 	Player *_owner;
 	int _gameTag;
-	ImVec2 _destinationPosition;
-	ImVec2 _destinationStep;
 	bool _moving;
 };
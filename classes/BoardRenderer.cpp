@@ -0,0 +1,95 @@
+#include "BoardRenderer.h"
+#include <algorithm>
+#include <cfloat>
+
+static const ImU32 HIGHLIGHT_COLOR = IM_COL32(255, 255, 0, 255);
+
+void BoardRenderer::begin()
+{
+    _quads.clear();
+    _min = ImVec2(FLT_MAX, FLT_MAX);
+    _max = ImVec2(-FLT_MAX, -FLT_MAX);
+}
+
+void BoardRenderer::addQuad(ImTextureID texture, const ImVec2 &position, const ImVec2 &size,
+                            const ImVec2 &uv0, const ImVec2 &uv1, const ImVec4 &color, bool highlighted)
+{
+    Quad quad;
+    quad.texture = texture;
+    quad.p0 = position;
+    quad.p1 = ImVec2(position.x + size.x, position.y + size.y);
+    quad.uv0 = uv0;
+    quad.uv1 = uv1;
+    quad.color = ImGui::ColorConvertFloat4ToU32(color);
+    quad.highlighted = highlighted;
+    _quads.push_back(quad);
+
+    _min = ImVec2(std::min(_min.x, quad.p0.x), std::min(_min.y, quad.p0.y));
+    _max = ImVec2(std::max(_max.x, quad.p1.x), std::max(_max.y, quad.p1.y));
+}
+
+void BoardRenderer::addRect(const ImVec2 &position, const ImVec2 &size, ImU32 color)
+{
+    Quad quad;
+    quad.texture = 0;
+    quad.p0 = position;
+    quad.p1 = ImVec2(position.x + size.x, position.y + size.y);
+    quad.color = color;
+    quad.highlighted = false;
+    _quads.push_back(quad);
+}
+
+void BoardRenderer::end()
+{
+    if (_quads.empty()) {
+        return;
+    }
+
+    // window coordinates are what ImGui::SetCursorPos takes, relative to the scrolled window
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    const ImVec2 windowPos = ImGui::GetWindowPos();
+    const ImVec2 origin(windowPos.x - ImGui::GetScrollX(), windowPos.y - ImGui::GetScrollY());
+
+    size_t first = 0;
+    while (first < _quads.size()) {
+        // a run ends at a texture change, or after a highlighted quad since its outline is drawn
+        // with imgui's own texture
+        size_t last = first + 1;
+        while (last < _quads.size() && _quads[last].texture == _quads[first].texture && !_quads[last - 1].highlighted) {
+            last++;
+        }
+
+        const int count = (int)(last - first);
+        const bool filled = _quads[first].texture == 0;
+        // plain rectangles stay on the window's own texture, which has the white pixel they use
+        if (!filled) {
+            drawList->PushTexture(_quads[first].texture);
+        }
+        drawList->PrimReserve(count * 6, count * 4);
+        for (size_t i = first; i < last; i++) {
+            const Quad &quad = _quads[i];
+            const ImVec2 p0(origin.x + quad.p0.x, origin.y + quad.p0.y);
+            const ImVec2 p1(origin.x + quad.p1.x, origin.y + quad.p1.y);
+            if (filled) {
+                drawList->PrimRect(p0, p1, quad.color);
+            } else {
+                drawList->PrimRectUV(p0, p1, quad.uv0, quad.uv1, quad.color);
+            }
+        }
+        if (!filled) {
+            drawList->PopTexture();
+        }
+
+        const Quad &lastQuad = _quads[last - 1];
+        if (lastQuad.highlighted) {
+            drawList->AddRect(ImVec2(origin.x + lastQuad.p0.x, origin.y + lastQuad.p0.y),
+                              ImVec2(origin.x + lastQuad.p1.x, origin.y + lastQuad.p1.y), HIGHLIGHT_COLOR);
+        }
+        first = last;
+    }
+
+    // one item over the whole board gives the window its content size, and holds the mouse so
+    // dragging a piece doesn't drag the window along with it
+    ImGui::SetCursorPos(_min);
+    ImGui::InvisibleButton("board", ImVec2(std::max(_max.x - _min.x, 1.0f), std::max(_max.y - _min.y, 1.0f)));
+}
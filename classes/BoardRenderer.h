@@ -0,0 +1,43 @@
+#pragma once
+#include "../imgui/imgui.h"
+#include <vector>
+
+//
+// draws the board straight into the window's draw list
+//
+// sprites queue one quad each while the board is walked and end() writes them out in that
+// order. quads sharing a texture, which is the whole board once the atlas is up, go into one
+// block of reserved vertices under one draw command. none of this makes imgui items, so hit
+// testing stays in Game::scanForMouse against the sprite rectangles
+//
+class BoardRenderer
+{
+public:
+    BoardRenderer() : _min(0, 0), _max(0, 0) {}
+
+    // start a board in the current window
+    void    begin();
+    // position is in window coordinates, the same ones the sprites and the mouse code use
+    void    addQuad(ImTextureID texture, const ImVec2 &position, const ImVec2 &size,
+                    const ImVec2 &uv0, const ImVec2 &uv1, const ImVec4 &color, bool highlighted);
+    // a plain filled rectangle, drawn in order with the quads
+    void    addRect(const ImVec2 &position, const ImVec2 &size, ImU32 color);
+    // write the quads and claim the area they cover in the window layout
+    void    end();
+
+private:
+    struct Quad
+    {
+        ImTextureID texture;
+        ImVec2      p0;
+        ImVec2      p1;
+        ImVec2      uv0;
+        ImVec2      uv1;
+        ImU32       color;
+        bool        highlighted;
+    };
+
+    std::vector<Quad>   _quads;     // kept between frames so the storage is reused
+    ImVec2              _min;
+    ImVec2              _max;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Search.h"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+//
+// fixed size binary copy of a board
+//
+// every cell holds a small value (the gameTag of the piece on it, 0 when empty) packed
+// 1, 2 or 4 bits at a time, so taking, comparing and hashing a snapshot never allocates.
+// cells are indexed the same way as the Grid, y * width + x
+//
+class BoardSnapshot
+{
+public:
+    static const int CAPACITY_BITS = 768;  // a 19x19 board at 2 bits a cell
+    static const int WORDS = CAPACITY_BITS / 64;
+
+    BoardSnapshot() : _cells(0), _bitsPerCell(2), _sideToMove(0) { std::memset(_words, 0, sizeof(_words)); }
+    BoardSnapshot(int cells, int bitsPerCell) : _cells((uint16_t)cells), _bitsPerCell((uint8_t)bitsPerCell), _sideToMove(0)
+    {
+        std::memset(_words, 0, sizeof(_words));
+        if (_cells * _bitsPerCell > CAPACITY_BITS) {
+            _cells = (uint16_t)(CAPACITY_BITS / _bitsPerCell);
+        }
+    }
+
+    int         cells() const { return _cells; }
+    int         bitsPerCell() const { return _bitsPerCell; }
+    int         sideToMove() const { return _sideToMove; }
+    void        setSideToMove(int player) { _sideToMove = (uint8_t)player; }
+
+    // bits per cell is a power of two, so a cell never straddles two words
+    int get(int cell) const
+    {
+        int bit = cell * _bitsPerCell;
+        return (int)((_words[bit >> 6] >> (bit & 63)) & cellMask());
+    }
+
+    void set(int cell, int value)
+    {
+        assert(cell >= 0 && cell < _cells);
+        int bit = cell * _bitsPerCell;
+        uint64_t &word = _words[bit >> 6];
+        word = (word & ~(cellMask() << (bit & 63))) | (((uint64_t)value & cellMask()) << (bit & 63));
+    }
+
+    uint64_t hash() const
+    {
+        uint64_t h = mixHash(((uint64_t)_cells << 16) | ((uint64_t)_bitsPerCell << 8) | _sideToMove);
+        for (int i = 0; i < usedWords(); i++) {
+            h = mixHash(h ^ _words[i]);
+        }
+        return h;
+    }
+
+    bool operator==(const BoardSnapshot &other) const
+    {
+        return _cells == other._cells && _bitsPerCell == other._bitsPerCell && _sideToMove == other._sideToMove &&
+               std::memcmp(_words, other._words, usedWords() * sizeof(uint64_t)) == 0;
+    }
+    bool operator!=(const BoardSnapshot &other) const { return !(*this == other); }
+
+    // one digit per cell, only for display and export
+    std::string toString() const
+    {
+        std::string s(_cells, '0');
+        for (int i = 0; i < _cells; i++) {
+            s[i] = (char)('0' + get(i));
+        }
+        return s;
+    }
+
+private:
+    uint64_t    cellMask() const { return (1ull << _bitsPerCell) - 1; }
+    int         usedWords() const { return (_cells * _bitsPerCell + 63) / 64; }
+
+    uint64_t    _words[WORDS];
+    uint16_t    _cells;
+    uint8_t     _bitsPerCell;
+    uint8_t     _sideToMove;
+};
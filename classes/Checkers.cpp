@@ -126,6 +126,8 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     int dstX = dstSquare->getColumn();
     int dstY = dstSquare->getRow();
 
+    GameMove move = GameMove::slide(holderIndex(src), holderIndex(dst), bit.gameTag(), bit.gameTag(), getCurrentPlayer()->playerNumber());
+
     // Check for jump
     ChessSquare* jumped = nullptr;
     if (dstSquare == _grid->getFLFL(srcX, srcY)) jumped = _grid->getFL(srcX, srcY);
@@ -135,6 +137,8 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
 
     if (jumped && jumped->bit()) {
         // Capture
+        move.capture = (uint16_t)holderIndex(*jumped);
+        move.captured = (uint8_t)jumped->bit()->gameTag();
         (jumped->bit()->getOwner() == getPlayerAt(RED_PLAYER)) ? _redPieces-- : _yellowPieces--;
         jumped->destroyBit();
 
@@ -145,6 +149,8 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
         }
 
         // Check for more jumps
+        move.piece = (uint8_t)bit.gameTag();
+        recordMove(move);
         if (canJumpFrom(*dstSquare)) {
             _mustContinueJumping = true;
             _jumpingPiece = &dst;
@@ -156,6 +162,8 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
             bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
             bit.setScale(1.3f);
         }
+        move.piece = (uint8_t)bit.gameTag();
+        recordMove(move);
     }
 
     _mustContinueJumping = false;
@@ -163,6 +171,26 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     endTurn();
 }
 
+void Checkers::makeMove(const GameMove &move) {
+    Game::makeMove(move);
+    if (move.capture != GameMove::NO_SQUARE) {
+        (move.captured == RED_PIECE || move.captured == RED_KING) ? _redPieces-- : _yellowPieces--;
+    }
+    // a jump that did not end the turn leaves the same piece to keep jumping
+    _mustContinueJumping = !move.isPass() && !move.endsTurn();
+    _jumpingPiece = _mustContinueJumping ? _grid->getSquare(move.to % 8, move.to / 8) : nullptr;
+}
+
+void Checkers::unmakeMove(const GameMove &move) {
+    Game::unmakeMove(move);
+    if (move.capture != GameMove::NO_SQUARE) {
+        (move.captured == RED_PIECE || move.captured == RED_KING) ? _redPieces++ : _yellowPieces++;
+    }
+    // undo always goes back to the start of a turn
+    _mustContinueJumping = false;
+    _jumpingPiece = nullptr;
+}
+
 bool Checkers::canJumpFrom(ChessSquare& square) const {
     Bit* piece = square.bit();
     if (!piece) return false;
@@ -12,6 +12,7 @@ public:
 
     // Required virtual methods from Game base class
     void        setUpBoard() override;
+    const char *gameName() const override { return "Checkers"; }
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
     std::string initialStateString() override;
@@ -22,6 +23,13 @@ public:
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
     void        stopGame() override;
     void        bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
+    // kings need a third bit, round up to keep cells word aligned
+    int         snapshotBitsPerCell() override { return 4; }
+
+    // undo / redo
+    void        makeMove(const GameMove &move) override;
+    void        unmakeMove(const GameMove &move) override;
+    Bit*        pieceForTag(int tag) override { return createPiece(tag); }
 
     // AI methods
     void        updateAI() override;
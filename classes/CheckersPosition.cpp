@@ -0,0 +1,218 @@
+#include "CheckersPosition.h"
+#include <bit>
+
+static const int MAN_VALUE = 100;
+static const int KING_VALUE = 160;
+// a little for every row a man has advanced, so the search pushes towards promotion
+static const int ADVANCE_VALUE = 3;
+
+// the four diagonal steps, red men use the first two and yellow men the last two
+static const int STEPS[4][2] = { {-1, 1}, {1, 1}, {-1, -1}, {1, -1} };
+
+static bool onBoard(int x, int y)
+{
+    return x >= 0 && x < 8 && y >= 0 && y < 8;
+}
+
+CheckersPosition::CheckersPosition()
+{
+    clear();
+}
+
+void CheckersPosition::clear()
+{
+    _men[0] = _men[1] = 0;
+    _kings[0] = _kings[1] = 0;
+    _side = 1;
+}
+
+void CheckersPosition::setUpStart()
+{
+    clear();
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            if ((x + y) % 2 == 1 && y != 3 && y != 4) {
+                setPiece(y * 8 + x, y < 3 ? 1 : 2, false);
+            }
+        }
+    }
+}
+
+void CheckersPosition::setPiece(int square, int player, bool king)
+{
+    uint64_t bit = 1ull << square;
+    for (int i = 0; i < 2; i++) {
+        _men[i] &= ~bit;
+        _kings[i] &= ~bit;
+    }
+    if (player) {
+        (king ? _kings : _men)[player - 1] |= bit;
+    }
+}
+
+void CheckersPosition::load(const BoardSnapshot &snapshot)
+{
+    clear();
+    for (int square = 0; square < 64 && square < snapshot.cells(); square++) {
+        switch (snapshot.get(square)) {
+            case RED_MAN: setPiece(square, 1, false); break;
+            case RED_KING: setPiece(square, 1, true); break;
+            case YELLOW_MAN: setPiece(square, 2, false); break;
+            case YELLOW_KING: setPiece(square, 2, true); break;
+        }
+    }
+    _side = snapshot.sideToMove() + 1;
+}
+
+int CheckersPosition::pieceCount(int player) const
+{
+    return std::popcount(pieces(player));
+}
+
+//
+// follow every jump chain from square, a chain only stops when the piece cannot jump again
+//
+void CheckersPosition::addJumps(MoveList<Move, MAX_MOVES> &list, int from, int square, bool king, uint64_t captured) const
+{
+    // the moving piece has left its square, and captured pieces stay on the board until the
+    // turn is over so they can not be jumped twice
+    const uint64_t empty = ~(occupied() & ~(1ull << from));
+    const uint64_t enemies = pieces(3 - _side) & ~captured;
+    const int firstStep = king ? 0 : (_side == 1 ? 0 : 2);
+    const int lastStep = king ? 4 : firstStep + 2;
+
+    bool jumped = false;
+    int x = square & 7, y = square >> 3;
+    for (int s = firstStep; s < lastStep; s++) {
+        int overX = x + STEPS[s][0], overY = y + STEPS[s][1];
+        int toX = overX + STEPS[s][0], toY = overY + STEPS[s][1];
+        if (!onBoard(toX, toY)) continue;
+        uint64_t over = 1ull << (overY * 8 + overX);
+        int to = toY * 8 + toX;
+        if (!(enemies & over) || !(empty & (1ull << to))) continue;
+
+        jumped = true;
+        // a man that is crowned keeps jumping as a king, the same as the game
+        bool crowned = !king && promotionRow(to, _side);
+        addJumps(list, from, to, king || crowned, captured | over);
+    }
+    if (!jumped && captured) {
+        Move move;
+        move.from = (uint8_t)from;
+        move.to = (uint8_t)square;
+        move.captured = captured;
+        move.promotes = !(_kings[_side - 1] & (1ull << from)) && (king || promotionRow(square, _side));
+        list.add(move);
+    }
+}
+
+void CheckersPosition::generateMoves(MoveList<Move, MAX_MOVES> &list) const
+{
+    const uint64_t own = pieces(_side);
+    const uint64_t kings = _kings[_side - 1];
+
+    for (uint64_t bits = own; bits; bits &= bits - 1) {
+        int square = std::countr_zero(bits);
+        addJumps(list, square, square, (kings >> square) & 1, 0);
+    }
+    if (!list.empty()) {
+        return;
+    }
+
+    const uint64_t empty = ~occupied();
+    for (uint64_t bits = own; bits; bits &= bits - 1) {
+        int square = std::countr_zero(bits);
+        bool king = (kings >> square) & 1;
+        int firstStep = king ? 0 : (_side == 1 ? 0 : 2);
+        int lastStep = king ? 4 : firstStep + 2;
+        int x = square & 7, y = square >> 3;
+        for (int s = firstStep; s < lastStep; s++) {
+            int toX = x + STEPS[s][0], toY = y + STEPS[s][1];
+            if (!onBoard(toX, toY) || !(empty & (1ull << (toY * 8 + toX)))) continue;
+            Move move;
+            move.from = (uint8_t)square;
+            move.to = (uint8_t)(toY * 8 + toX);
+            move.promotes = !king && promotionRow(move.to, _side);
+            list.add(move);
+        }
+    }
+}
+
+void CheckersPosition::makeMove(Move &move)
+{
+    const int me = _side - 1, them = 2 - _side;
+    const uint64_t from = 1ull << move.from, to = 1ull << move.to;
+
+    // clear then set rather than toggle, a king's jump chain can end on the square it left
+    if (_kings[me] & from) {
+        _kings[me] = (_kings[me] & ~from) | to;
+    } else if (move.promotes) {
+        _men[me] &= ~from;
+        _kings[me] |= to;
+    } else {
+        _men[me] = (_men[me] & ~from) | to;
+    }
+    move.capturedKings = _kings[them] & move.captured;
+    _men[them] &= ~move.captured;
+    _kings[them] &= ~move.captured;
+    _side = 3 - _side;
+}
+
+void CheckersPosition::unmakeMove(const Move &move)
+{
+    _side = 3 - _side;
+    const int me = _side - 1, them = 2 - _side;
+    const uint64_t from = 1ull << move.from, to = 1ull << move.to;
+
+    _men[them] |= move.captured & ~move.capturedKings;
+    _kings[them] |= move.capturedKings;
+    if (move.promotes) {
+        _kings[me] &= ~to;
+        _men[me] |= from;
+    } else if (_kings[me] & to) {
+        _kings[me] = (_kings[me] & ~to) | from;
+    } else {
+        _men[me] = (_men[me] & ~to) | from;
+    }
+}
+
+int CheckersPosition::evaluate() const
+{
+    int score[2];
+    for (int i = 0; i < 2; i++) {
+        score[i] = std::popcount(_men[i]) * MAN_VALUE + std::popcount(_kings[i]) * KING_VALUE;
+        for (uint64_t bits = _men[i]; bits; bits &= bits - 1) {
+            int row = std::countr_zero(bits) >> 3;
+            score[i] += ADVANCE_VALUE * (i == 0 ? row : 7 - row);
+        }
+    }
+    return score[_side - 1] - score[2 - _side];
+}
+
+uint64_t CheckersPosition::hash() const
+{
+    return mixHash(mixHash(mixHash(mixHash(_men[0] + _side) ^ _men[1]) ^ _kings[0]) ^ _kings[1]);
+}
+
+bool CheckersPosition::isTerminal(int &score) const
+{
+    // a side with no pieces or no legal move has lost
+    if (pieces(_side)) {
+        MoveList<Move, MAX_MOVES> moves;
+        generateMoves(moves);
+        if (!moves.empty()) {
+            return false;
+        }
+    }
+    score = -SEARCH_WIN;
+    return true;
+}
+
+// from and to squares, joined with x for a capture
+std::string CheckersPosition::moveText(const Move &move) const
+{
+    auto square = [](int index) {
+        return std::string(1, (char)('a' + (index & 7))) + std::to_string((index >> 3) + 1);
+    };
+    return square(move.from) + (move.captured ? "x" : "-") + square(move.to);
+}
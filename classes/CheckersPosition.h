@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Search.h"
+#include "BoardSnapshot.h"
+#include <cstdint>
+
+//
+// checkers rules on bitboards, for the search and for tools that run without the gui
+//
+// squares are the Grid index y * 8 + x and only the dark squares ((x + y) odd) are used.
+// players are 1 (red, starts at the top and moves down the board) and 2 (yellow).
+// captures are compulsory and a move is a whole turn, a jump chain included
+//
+class CheckersPosition
+{
+public:
+    struct Move
+    {
+        uint8_t     from = 0;
+        uint8_t     to = 0;
+        bool        promotes = false;
+        uint64_t    captured = 0;
+        uint64_t    capturedKings = 0;      // filled in by makeMove for unmakeMove
+        bool        operator==(const Move &other) const { return from == other.from && to == other.to && captured == other.captured; }
+    };
+    static const int MAX_MOVES = 48;
+
+    // snapshot gameTags, the same values the Checkers game gives its pieces
+    static const int RED_MAN = 1;
+    static const int RED_KING = 2;
+    static const int YELLOW_MAN = 3;
+    static const int YELLOW_KING = 4;
+
+    CheckersPosition();
+
+    void        clear();
+    // the standard opening position, red to move
+    void        setUpStart();
+    void        setPiece(int square, int player, bool king);
+    // cells hold the gameTags above, the snapshot's side to move is a player number
+    void        load(const BoardSnapshot &snapshot);
+    void        setSideToMove(int player) { _side = player; }
+    int         sideToMove() const { return _side; }
+    int         pieceCount(int player) const;
+
+    // SearchPosition
+    void        generateMoves(MoveList<Move, MAX_MOVES> &list) const;
+    void        makeMove(Move &move);
+    void        unmakeMove(const Move &move);
+    int         evaluate() const;
+    uint64_t    hash() const;
+    bool        isTerminal(int &score) const;
+    std::string moveText(const Move &move) const;
+
+private:
+    void        addJumps(MoveList<Move, MAX_MOVES> &list, int from, int square, bool king, uint64_t captured) const;
+    uint64_t    occupied() const { return _men[0] | _men[1] | _kings[0] | _kings[1]; }
+    uint64_t    pieces(int player) const { return _men[player - 1] | _kings[player - 1]; }
+    bool        promotionRow(int square, int player) const { return (square >> 3) == (player == 1 ? 7 : 0); }
+
+    uint64_t    _men[2];
+    uint64_t    _kings[2];
+    int         _side;
+};
@@ -8,9 +8,10 @@
 static const int COLUMNS = 7;
 static const int ROWS = 6;
 static const int STATE_SIZE = COLUMNS * ROWS;
-static const int MAX_DEPTH = 6; // adjust for performance/strength
+// the fall from above the board, bounce included
+static const float DROP_SECONDS = 0.6f;
 
-Connect4::Connect4() : Game() {
+Connect4::Connect4() : Game(), _aiThread(_searcher) {
     _grid = new Grid(COLUMNS, ROWS);
     _redPieces = 0;
     _yellowPieces = 0;
@@ -108,9 +109,8 @@ bool Connect4::actionForEmptyHolder(BitHolder &holder) {
             // place bit in holder (this takes ownership)
             target->setBit(bit);
 
-            // animate piece to final spot if engine supports moveTo()
-            // Many other classes call bit->moveTo() to animate; do the same.
-            bit->moveTo(target->getPosition());
+            // drop it into place with a bounce at the bottom
+            bit->moveTo(target->getPosition(), DROP_SECONDS, Easing::EaseOutBounce);
 
             // update counters
             if (pieceType == RED_PIECE) ++_redPieces; else ++_yellowPieces;
@@ -118,6 +118,7 @@ bool Connect4::actionForEmptyHolder(BitHolder &holder) {
             // clear highlights
             clearHighlights();
 
+            recordMove(GameMove::drop(holderIndex(*target), pieceType, playerNum));
             endTurn();
             return true;
         }
@@ -127,6 +128,18 @@ bool Connect4::actionForEmptyHolder(BitHolder &holder) {
     return false;
 }
 
+void Connect4::makeMove(const GameMove &move) {
+    Game::makeMove(move);
+    if (move.isPass()) return;
+    if (move.piece == RED_PIECE) ++_redPieces; else ++_yellowPieces;
+}
+
+void Connect4::unmakeMove(const GameMove &move) {
+    Game::unmakeMove(move);
+    if (move.isPass()) return;
+    if (move.piece == RED_PIECE) --_redPieces; else --_yellowPieces;
+}
+
 Player* Connect4::checkForWinner() {
     const int dirs[4][2] = { {1,0}, {0,1}, {1,1}, {1,-1} };
 
@@ -214,6 +227,8 @@ void Connect4::setStateString(const std::string &s) {
 }
 
 void Connect4::stopGame() {
+    stopAI();
+    _hints.cancel();
     _grid->forEachSquare([](ChessSquare* square, int x, int y){
         square->destroyBit();
         square->setHighlighted(false);
@@ -236,155 +251,49 @@ bool Connect4::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
 // -------------------- AI implementation --------------------
 //
 
-bool Connect4::aiBoardFull(const std::string& state) const {
-    return state.find('0') == std::string::npos;
-}
-
-bool Connect4::columnFull(const std::string& state, int col) const {
-    // top row (y=0) index = 0 * COLUMNS + col
-    return state[col] != '0';
-}
-
-void Connect4::applyMoveToState(std::string& state, int col, char pieceChar) const {
-    // drop from bottom (y = ROWS-1) upward
-    for (int y = ROWS - 1; y >= 0; --y) {
-        int idx = y * COLUMNS + col;
-        if (state[idx] == '0') {
-            state[idx] = pieceChar;
-            return;
-        }
-    }
-    // column full -> no change
-}
-
-int Connect4::evaluate(const std::string& state, int aiPieceChar) const {
-    const int OPP = (aiPieceChar == 1) ? 2 : 1;
-    const int WIN_SCORE = 100000;
-    const int THREE_OPEN = 1000;
-    const int TWO_OPEN = 50;
-
-    auto scoreWindow = [&](int x0, int y0, int dx, int dy) -> int {
-        int aiCount = 0, oppCount = 0, emptyCount = 0;
-        for (int k = 0; k < 4; ++k) {
-            int x = x0 + dx * k;
-            int y = y0 + dy * k;
-            if (x < 0 || x >= COLUMNS || y < 0 || y >= ROWS) return 0; // invalid window
-            char c = state[y * COLUMNS + x];
-            if (c == '0') ++emptyCount;
-            else if (c - '0' == aiPieceChar) ++aiCount;
-            else ++oppCount;
-        }
-        if (aiCount == 4) return WIN_SCORE;
-        if (oppCount == 4) return -WIN_SCORE;
-
-        int val = 0;
-        if (aiCount == 3 && emptyCount == 1) val += THREE_OPEN;
-        else if (aiCount == 2 && emptyCount == 2) val += TWO_OPEN;
-        if (oppCount == 3 && emptyCount == 1) val -= (THREE_OPEN - 200); // slightly prioritize blocking
-        else if (oppCount == 2 && emptyCount == 2) val -= TWO_OPEN;
-        return val;
-    };
-
-    int total = 0;
-    for (int y = 0; y < ROWS; ++y) {
-        for (int x = 0; x < COLUMNS; ++x) {
-            total += scoreWindow(x, y, 1, 0);  // horizontal
-            total += scoreWindow(x, y, 0, 1);  // vertical
-            total += scoreWindow(x, y, 1, 1);  // diag down-right
-            total += scoreWindow(x, y, 1, -1); // diag up-right
-        }
-    }
-    return total;
-}
-
-int Connect4::negamax(std::string& state, int depth, int currentPlayerChar, int aiPieceChar, int alpha, int beta) {
-    // currentPlayerChar: 1 or 2 (which player is about to move)
-    // aiPieceChar: the char representing AI (1 or 2)
-    int evalScore = evaluate(state, aiPieceChar);
-
-    // terminal checks
-    if (std::abs(evalScore) >= 100000) {
-        // someone has 4 in a row in state
-        return evalScore;
-    }
-    if (aiBoardFull(state) || depth >= MAX_DEPTH) {
-        return evalScore;
-    }
-
-    int best = -10000000;
-    // order columns: prefer center for heuristic
-    const int colOrder[7] = {3, 2, 4, 1, 5, 0, 6};
-    for (int ic = 0; ic < COLUMNS; ++ic) {
-        int col = colOrder[ic];
-        if (columnFull(state, col)) continue;
-        std::string next = state;
-        char ch = (currentPlayerChar == 1) ? '1' : '2';
-        applyMoveToState(next, col, ch);
-        int nextPlayer = (currentPlayerChar == 1) ? 2 : 1;
-        int val = -negamax(next, depth + 1, nextPlayer, aiPieceChar, -beta, -alpha);
-        if (val > best) best = val;
-        alpha = std::max(alpha, val);
-        if (alpha >= beta) break; // alpha-beta prune
-    }
-    return best;
-}
-
 void Connect4::updateAI() {
     Player* cur = getCurrentPlayer();
     if (!cur) return;
     int aiIndex = cur->playerNumber();
     int aiChar = (aiIndex == RED_PLAYER) ? 1 : 2;
-    int oppChar = (aiChar == 1) ? 2 : 1;
-
-    std::string state = stateString();
-
-    // 1) Immediate win
-    for (int col = 0; col < COLUMNS; ++col) {
-        if (columnFull(state, col)) continue;
-        std::string tmp = state;
-        applyMoveToState(tmp, col, char('0' + aiChar));
-        if (evaluate(tmp, aiChar) >= 100000) {
-            // play this winning move
-            bestPlayColumnAndReturn(col, aiChar);
-            return;
-        }
-    }
 
-    // 2) Immediate block of opponent's win
-    for (int col = 0; col < COLUMNS; ++col) {
-        if (columnFull(state, col)) continue;
-        std::string tmp = state;
-        applyMoveToState(tmp, col, char('0' + oppChar));
-        if (evaluate(tmp, oppChar) >= 100000) {
-            // must block by playing this column
-            bestPlayColumnAndReturn(col, aiChar);
-            return;
-        }
-    }
-
-    // 3) Negamax search with alpha-beta and center-first ordering
-    int bestCol = -1;
-    int bestScore = -100000000;
-    const int colOrder[7] = {3, 2, 4, 1, 5, 0, 6};
-    for (int i = 0; i < COLUMNS; ++i) {
-        int col = colOrder[i];
-        if (columnFull(state, col)) continue;
-        std::string s2 = state;
-        applyMoveToState(s2, col, char('0' + aiChar));
-        int nextPlayer = oppChar;
-        int score = -negamax(s2, 1, nextPlayer, aiChar, -100000000, 100000000);
-        if (score > bestScore) {
-            bestScore = score;
-            bestCol = col;
+    Connect4Position position;
+    position.load(snapshot());
+    // the search runs on its own thread, this is called every frame until its result is in
+    SearchResult<Connect4Position::Move> result;
+    if (_aiThread.poll(position, aiSearchLimits(), result) && result.hasMove) {
+        bestPlayColumnAndReturn(result.bestMove.column, aiChar);
+        if (shouldPonder()) {
+            _aiThread.ponder(position, result, aiSearchLimits());
         }
     }
+}
 
-    if (bestCol == -1) {
-        for (int c = 0; c < COLUMNS; ++c) if (!columnFull(state, c)) { bestCol = c; break; }
+//
+// each column is tinted where its piece would land
+//
+void Connect4::drawHints(BoardRenderer &renderer) {
+    // the position just played is the AI's to think about, it gets the cpu to itself
+    if (getCurrentPlayer()->isAIPlayer()) {
+        _hints.cancel();
+        return;
     }
-
-    if (bestCol >= 0) {
-        bestPlayColumnAndReturn(bestCol, aiChar);
+    Connect4Position position;
+    position.load(snapshot());
+    _hints.request(position, hintSearchLimits());
+    const auto *hints = _hints.find(position);
+    if (!hints) return;
+
+    int low, high;
+    hints->range(low, high);
+    for (const auto &hint : hints->moves) {
+        for (int row = ROWS - 1; row >= 0; --row) {
+            ChessSquare* sq = _grid->getSquare(hint.move.column, row);
+            if (sq && !sq->bit()) {
+                drawHint(renderer, *sq, hint.score, low, high);
+                break;
+            }
+        }
     }
 }
 
@@ -400,9 +309,10 @@ void Connect4::bestPlayColumnAndReturn(int bestCol, int aiChar) {
             startPos.y = startPos.y - 80.0f * (ROWS);
             bit->setPosition(startPos);
             sq->setBit(bit);
-            bit->moveTo(sq->getPosition());
+            bit->moveTo(sq->getPosition(), DROP_SECONDS, Easing::EaseOutBounce);
             if (pieceType == RED_PIECE) ++_redPieces; else ++_yellowPieces;
             clearHighlights();
+            recordMove(GameMove::drop(holderIndex(*sq), pieceType, getCurrentPlayer()->playerNumber()));
             endTurn();
             return;
         }
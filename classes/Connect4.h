@@ -2,6 +2,9 @@
 
 #include "Game.h"
 #include "Grid.h"
+#include "Connect4Position.h"
+#include "SearchThread.h"
+#include "HintThread.h"
 #include <string>
 
 class Connect4 : public Game {
@@ -11,6 +14,7 @@ public:
 
     // Game lifecycle
     void        setUpBoard() override;
+    const char *gameName() const override { return "Connect4"; }
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
     std::string initialStateString() override;
@@ -19,14 +23,27 @@ public:
     bool        actionForEmptyHolder(BitHolder &holder) override;
     void        stopGame() override;
 
+    // undo / redo
+    void        makeMove(const GameMove &move) override;
+    void        unmakeMove(const GameMove &move) override;
+    Bit*        pieceForTag(int tag) override { return createPiece(tag); }
+
     bool        canBitMoveFrom(Bit &bit, BitHolder &src) override;
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
 
     // AI
     void        updateAI() override;
+    void        stopAI() override { _aiThread.cancel(); }
+    bool        searchStats(SearchStats &stats) const override { stats = _aiThread.stats(); return true; }
     bool        gameHasAI() override { return true; }
+    bool        hasHints() override { return true; }
+    bool        hintsRunning() const override { return _hints.running(); }
+    void        stopHints() override { _hints.cancel(); }
     Grid*       getGrid() override { return _grid; }
 
+protected:
+    void        drawHints(BoardRenderer &renderer) override;
+
 private:
     // piece constants (gametag values)
     static const int EMPTY = 0;
@@ -45,15 +62,13 @@ private:
     void        clearHighlights();
 
     // AI helpers
-    bool        aiBoardFull(const std::string& state) const;
-    int         evaluate(const std::string& state, int aiPieceChar) const;
-    int         negamax(std::string& state, int depth, int currentPlayerChar, int aiPieceChar, int alpha, int beta);
-    void        applyMoveToState(std::string& state, int col, char pieceChar) const;
-    bool        columnFull(const std::string& state, int col) const;
     void bestPlayColumnAndReturn(int bestCol, int aiChar);
 
     // board
     Grid*       _grid;
+    Searcher<Connect4Position> _searcher;
+    SearchThread<Searcher<Connect4Position>, Connect4Position> _aiThread;
+    HintThread<Connect4Position> _hints;
 
     // counts (not strictly required but kept)
     int         _redPieces;
@@ -0,0 +1,215 @@
+#include "Connect4Position.h"
+#include <bit>
+#include <vector>
+
+static const int H1 = Connect4Position::ROWS + 1;
+static const int COLUMN_ORDER[Connect4Position::COLUMNS] = {3, 2, 4, 1, 5, 0, 6};
+
+static uint64_t boardMask()
+{
+    uint64_t mask = 0;
+    for (int c = 0; c < Connect4Position::COLUMNS; c++) {
+        mask |= ((1ull << Connect4Position::ROWS) - 1) << (c * H1);
+    }
+    return mask;
+}
+
+static uint64_t bottomMask()
+{
+    uint64_t mask = 0;
+    for (int c = 0; c < Connect4Position::COLUMNS; c++) {
+        mask |= 1ull << (c * H1);
+    }
+    return mask;
+}
+
+static const uint64_t BOARD_MASK = boardMask();
+static const uint64_t BOTTOM_MASK = bottomMask();
+
+//
+// every line of four on the board as a bitmask, used by the evaluation
+//
+static std::vector<uint64_t> buildWindows()
+{
+    std::vector<uint64_t> windows;
+    const int dirs[4][2] = { {1,0}, {0,1}, {1,1}, {1,-1} };
+    for (int d = 0; d < 4; d++) {
+        for (int c = 0; c < Connect4Position::COLUMNS; c++) {
+            for (int r = 0; r < Connect4Position::ROWS; r++) {
+                uint64_t window = 0;
+                int k = 0;
+                for (; k < 4; k++) {
+                    int cc = c + dirs[d][0] * k;
+                    int rr = r + dirs[d][1] * k;
+                    if (cc < 0 || cc >= Connect4Position::COLUMNS || rr < 0 || rr >= Connect4Position::ROWS) break;
+                    window |= 1ull << (cc * H1 + rr);
+                }
+                if (k == 4) windows.push_back(window);
+            }
+        }
+    }
+    return windows;
+}
+
+static const std::vector<uint64_t> WINDOWS = buildWindows();
+
+Connect4Position::Connect4Position()
+{
+    clear();
+}
+
+void Connect4Position::clear()
+{
+    _stones[0] = _stones[1] = 0;
+    _mask = 0;
+    _side = 1;
+    _plies = 0;
+}
+
+void Connect4Position::setStone(int column, int row, int player)
+{
+    uint64_t bit = 1ull << (column * H1 + (ROWS - 1 - row));
+    _stones[player - 1] |= bit;
+    _mask |= bit;
+    _plies++;
+}
+
+void Connect4Position::load(const BoardSnapshot &snapshot)
+{
+    clear();
+    for (int cell = 0; cell < COLUMNS * ROWS && cell < snapshot.cells(); cell++) {
+        int player = snapshot.get(cell);
+        if (player) {
+            setStone(cell % COLUMNS, cell / COLUMNS, player);
+        }
+    }
+    setSideToMove(snapshot.sideToMove() + 1);
+}
+
+bool Connect4Position::hasFour(uint64_t stones)
+{
+    // vertical, horizontal and the two diagonals are shifts of 1, H1, H1-1 and H1+1
+    const int shifts[4] = { 1, H1, H1 - 1, H1 + 1 };
+    for (int shift : shifts) {
+        uint64_t pairs = stones & (stones >> shift);
+        if (pairs & (pairs >> (2 * shift))) return true;
+    }
+    return false;
+}
+
+//
+// empty cells that would complete a four for stones, whether or not they are playable yet
+//
+uint64_t Connect4Position::winningCells(uint64_t stones, uint64_t mask)
+{
+    // vertical
+    uint64_t cells = (stones << 1) & (stones << 2) & (stones << 3);
+
+    // horizontal and the two diagonals, the gap can be at either end or in the middle
+    const int shifts[3] = { H1, H1 - 1, H1 + 1 };
+    for (int s : shifts) {
+        uint64_t pair = (stones << s) & (stones << (2 * s));
+        cells |= pair & (stones << (3 * s));
+        cells |= pair & (stones >> s);
+        pair = (stones >> s) & (stones >> (2 * s));
+        cells |= pair & (stones << s);
+        cells |= pair & (stones >> (3 * s));
+    }
+    return cells & (BOARD_MASK ^ mask);
+}
+
+uint64_t Connect4Position::playableCells() const
+{
+    return (_mask + BOTTOM_MASK) & BOARD_MASK;
+}
+
+void Connect4Position::generateMoves(MoveList<Move, MAX_MOVES> &list) const
+{
+    const uint64_t playable = playableCells();
+    // a win ends the game and an unanswered threat loses it, neither needs alternatives
+    uint64_t forced = playable & winningCells(_stones[_side - 1], _mask);
+    if (!forced) {
+        forced = playable & winningCells(_stones[2 - _side], _mask);
+    }
+    for (int column : COLUMN_ORDER) {
+        if (!canPlay(column)) continue;
+        if (forced && !(forced & columnMask(column))) continue;
+        list.add({ column });
+        if (forced) return;
+    }
+}
+
+void Connect4Position::generateAllMoves(std::vector<Move> &moves) const
+{
+    for (int column : COLUMN_ORDER) {
+        if (canPlay(column)) {
+            moves.push_back({ column });
+        }
+    }
+}
+
+void Connect4Position::makeMove(Move &move)
+{
+    uint64_t bit = (_mask + bottomBit(move.column)) & columnMask(move.column);
+    _stones[_side - 1] |= bit;
+    _mask |= bit;
+    _side = 3 - _side;
+    _plies++;
+}
+
+void Connect4Position::unmakeMove(const Move &move)
+{
+    _side = 3 - _side;
+    uint64_t column = _mask & columnMask(move.column);
+    uint64_t bit = 1ull << (63 - std::countl_zero(column));
+    _stones[_side - 1] &= ~bit;
+    _mask &= ~bit;
+    _plies--;
+}
+
+//
+// open threes and twos for the side to move minus the same for the opponent, plus a little for the centre
+//
+int Connect4Position::evaluate() const
+{
+    const int THREE = 1000;
+    const int TWO = 50;
+    const uint64_t own = _stones[_side - 1];
+    const uint64_t opp = _stones[2 - _side];
+
+    int score = 0;
+    for (uint64_t window : WINDOWS) {
+        int mine = std::popcount(own & window);
+        int theirs = std::popcount(opp & window);
+        if (mine && theirs) continue;
+        if (mine == 3) score += THREE;
+        else if (mine == 2) score += TWO;
+        else if (theirs == 3) score -= THREE;
+        else if (theirs == 2) score -= TWO;
+    }
+    score += 3 * (std::popcount(own & columnMask(3)) - std::popcount(opp & columnMask(3)));
+    return score;
+}
+
+bool Connect4Position::isTerminal(int &score) const
+{
+    if (hasFour(_stones[2 - _side])) {
+        score = -SEARCH_WIN;
+        return true;
+    }
+    if (hasFour(_stones[_side - 1])) {
+        score = SEARCH_WIN;
+        return true;
+    }
+    if (_plies >= COLUMNS * ROWS) {
+        score = 0;
+        return true;
+    }
+    return false;
+}
+
+// columns are numbered from 1 on the left
+std::string Connect4Position::moveText(const Move &move) const
+{
+    return std::to_string(move.column + 1);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Search.h"
+#include "BoardSnapshot.h"
+#include <cstdint>
+#include <vector>
+
+//
+// connect 4 as a pair of bitboards for the search
+//
+// each column takes 7 bits, the bottom row is bit 0 of its column and the 7th bit is
+// always empty so shifts never carry a line from one column into the next.
+// players are 1 (red) and 2 (yellow), rows are counted from the top like the Grid
+//
+class Connect4Position
+{
+public:
+    struct Move
+    {
+        int     column = -1;
+        bool    operator==(const Move &other) const = default;
+    };
+    static const int COLUMNS = 7;
+    static const int ROWS = 6;
+    static const int MAX_MOVES = COLUMNS;
+
+    Connect4Position();
+
+    void        clear();
+    void        setStone(int column, int row, int player);
+    // cells hold 0, 1 (red) or 2 (yellow), the snapshot's side to move is a player number
+    void        load(const BoardSnapshot &snapshot);
+    void        setSideToMove(int player) { _side = player; }
+    int         sideToMove() const { return _side; }
+    bool        canPlay(int column) const { return (_mask & topBit(column)) == 0; }
+
+    // SearchPosition
+    void        generateMoves(MoveList<Move, MAX_MOVES> &list) const;
+    // every playable column, generateMoves only gives the forced one when there is a threat
+    void        generateAllMoves(std::vector<Move> &moves) const;
+    void        makeMove(Move &move);
+    void        unmakeMove(const Move &move);
+    int         evaluate() const;
+    uint64_t    hash() const { return mixHash(_stones[_side - 1] + _mask); }
+    bool        isTerminal(int &score) const;
+    std::string moveText(const Move &move) const;
+
+private:
+    static uint64_t bottomBit(int column) { return 1ull << (column * (ROWS + 1)); }
+    static uint64_t topBit(int column) { return 1ull << (column * (ROWS + 1) + ROWS - 1); }
+    static uint64_t columnMask(int column) { return ((1ull << ROWS) - 1) << (column * (ROWS + 1)); }
+    static bool     hasFour(uint64_t stones);
+    static uint64_t winningCells(uint64_t stones, uint64_t mask);
+    uint64_t        playableCells() const;
+
+    uint64_t    _stones[2];
+    uint64_t    _mask;
+    int         _side;
+    int         _plies;
+};
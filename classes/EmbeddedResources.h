@@ -0,0 +1,17 @@
+#pragma once
+
+//
+// the resource images, decoded to RGBA at build time and compiled into the executable
+// by tools/embed_resources, so the app needs neither the resources directory nor a png decoder
+// to start
+//
+struct EmbeddedImage
+{
+    const char          *name;      // file name in resources/
+    int                 width;
+    int                 height;
+    const unsigned char *pixels;    // width * height * 4 bytes
+};
+
+extern const EmbeddedImage EMBEDDED_IMAGES[];
+extern const int EMBEDDED_IMAGE_COUNT;
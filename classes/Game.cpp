@@ -1,8 +1,19 @@
 #include "Game.h"
 #include "Bit.h"
 #include "BitHolder.h"
-#include "Turn.h"
 #include "../Application.h"
+#include "Profiler.h"
+
+// the web build has no thread to run the AI on, so it searches a slice of every frame instead
+#ifdef __EMSCRIPTEN__
+static const int DEFAULT_AI_SLICE_US = 6000;
+#else
+static const int DEFAULT_AI_SLICE_US = 0;
+#endif
+// the hints search each position for at most this long, however deep AIMAXDepth allows
+static const int HINT_TIME_MS = 3000;
+static const float HINT_ALPHA = 0.45f;
+static const float HINT_PROVEN_ALPHA = 0.7f;
 
 Game::Game()
 {
@@ -15,7 +26,12 @@ Game::Game()
 	_gameOptions.rowY = 0;
 	_gameOptions.score = 0;
 	_gameOptions.AIDepthSearches = 0;
+	_gameOptions.AIMAXDepth = SEARCH_MAX_PLY;
+	_gameOptions.AITimeLimitMs = 500;
 	_gameOptions.AIvsAI = false;
+	_gameOptions.AIPonder = true;
+	_gameOptions.AISliceUs = DEFAULT_AI_SLICE_US;
+	_gameOptions.showHints = false;
 
 	_table = nullptr;
 	_winner = nullptr;
@@ -28,15 +44,13 @@ Game::Game()
 	_dragStartPos = ImVec2(0, 0);
 	_dragOffset = ImVec2(0, 0);
 	_oldPos = ImVec2(0, 0);
+	_journal = nullptr;
+	_journalWritten = -1;
+	_journalValid = 0;
 }
 
 Game::~Game()
 {
-	for (auto &_turn : _turns)
-	{
-		delete _turn;
-	}
-	_turns.clear();
 	for (auto &_player : _players)
 	{
 		delete _player;
@@ -65,10 +79,6 @@ void Game::setNumberOfPlayers(unsigned int n)
 
 	_gameOptions.gameNumber = 0;
 	_gameOptions.numberOfPlayers = n;
-
-	Turn *turn = Turn::initStartOfGame(this);
-	_turns.clear();
-	_turns.push_back(turn);
 }
 
 void Game::setAIPlayer(unsigned int playerNumber)
@@ -80,26 +90,252 @@ void Game::setAIPlayer(unsigned int playerNumber)
 
 void Game::startGame()
 {
-	std::string startState = stateString();
-	Turn *turn = _turns.at(0);
-	turn->_boardState = startState;
-	turn->_gameNumber = _gameOptions.gameNumber;
 	_gameOptions.currentTurnNo = 0;
+	_history.reset(snapshot());
+	_journalWritten = -1;
+}
+
+void Game::recordMove(const GameMove &move)
+{
+	// a move played after an undo replaces the moves that were taken back
+	_journalValid = std::min(_journalValid, _history.cursor());
+	_history.push(move);
 }
 
 void Game::endTurn()
 {
+	if (_history.movesThisTurn() == 0)
+	{
+		// nothing was played, the player passed
+		recordMove(GameMove::pass(getCurrentPlayer()->playerNumber()));
+	}
+	_history.closeTurn();
 	_gameOptions.currentTurnNo++;
-	std::string startState = stateString();
-	Turn *turn = new Turn;
-	turn->_boardState = stateString();
-	turn->_date = (int)_gameOptions.currentTurnNo;
-	turn->_score = _gameOptions.score;
-	turn->_gameNumber = _gameOptions.gameNumber;
-	_turns.push_back(turn);
+	writeJournal();
 	ClassGame::EndOfTurn();
 }
 
+void Game::writeJournal()
+{
+	if (!_journal)
+	{
+		return;
+	}
+	// only the new moves are encoded, unless the history changed under the journal
+	if (_journalWritten < 0 || _journalValid < _journalWritten)
+	{
+		_journal->restart(recordHeader());
+		_journalWritten = 0;
+	}
+	for (int ply = _journalWritten; ply < _history.cursor(); ply++)
+	{
+		_journal->append(_history.at(ply));
+	}
+	_journalWritten = _journalValid = _history.cursor();
+}
+
+bool Game::undo()
+{
+	stopAI();
+	int end = _history.cursor();
+	if (end == 0)
+	{
+		return false;
+	}
+	// a turn still in progress (a checkers jump chain) is taken back first and keeps the turn number
+	int start = _history.turnStartBefore(end);
+	bool closed = _history.at(end - 1).endsTurn();
+	for (int ply = end - 1; ply >= start; ply--)
+	{
+		unmakeMove(_history.at(ply));
+	}
+	_history.setCursor(start);
+	if (closed)
+	{
+		_gameOptions.currentTurnNo--;
+	}
+	return true;
+}
+
+bool Game::redo()
+{
+	stopAI();
+	int start = _history.cursor();
+	if (!_history.canRedo())
+	{
+		return false;
+	}
+	int end = _history.turnEndAfter(start);
+	for (int ply = start; ply < end; ply++)
+	{
+		makeMove(_history.at(ply));
+	}
+	_history.setCursor(end);
+	if (_history.at(end - 1).endsTurn())
+	{
+		_gameOptions.currentTurnNo++;
+	}
+	return true;
+}
+
+void Game::gotoPly(int ply)
+{
+	stopAI();
+	ply = std::clamp(ply, 0, _history.size());
+	int cursor = _history.cursor();
+	for (; cursor > ply; cursor--)
+	{
+		unmakeMove(_history.at(cursor - 1));
+	}
+	for (; cursor < ply; cursor++)
+	{
+		makeMove(_history.at(cursor));
+	}
+	_history.setCursor(ply);
+
+	// the turn number is the count of finished turns on the board
+	unsigned int turns = 0;
+	for (int i = 0; i < ply; i++)
+	{
+		if (_history.at(i).endsTurn())
+		{
+			turns++;
+		}
+	}
+	_gameOptions.currentTurnNo = turns;
+}
+
+GameRecordHeader Game::recordHeader()
+{
+	GameRecordHeader header;
+	header.gameName = gameName();
+	header.width = getGrid()->getWidth();
+	header.height = getGrid()->getHeight();
+	for (size_t i = 0; i < _players.size(); i++)
+	{
+		if (_players[i]->isAIPlayer())
+		{
+			header.aiPlayers |= 1 << i;
+		}
+	}
+	header.maxDepth = _gameOptions.AIMAXDepth;
+	header.timeMs = _gameOptions.AITimeLimitMs;
+	header.start = _history.positionAt(0);
+	return header;
+}
+
+bool Game::saveRecord(const std::string &path)
+{
+	return saveGameRecord(path, recordHeader(), _history);
+}
+
+bool Game::loadRecord(GameRecordReader &reader, const GameRecordHeader &header)
+{
+	if (header.gameName != gameName() || header.start != snapshot())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < _players.size(); i++)
+	{
+		_players[i]->setAIPlayer((header.aiPlayers >> i) & 1);
+	}
+	_gameOptions.AIMAXDepth = header.maxDepth;
+	_gameOptions.AITimeLimitMs = header.timeMs;
+
+	// the moves go into the history without touching the board, then the board catches up in one go
+	_history.reset(header.start);
+	GameMove move;
+	while (reader.nextMove(move))
+	{
+		_history.push(move);
+		if (move.endsTurn())
+		{
+			_history.closeTurn();
+		}
+	}
+	_history.setCursor(0);
+	gotoPly(_history.size());
+	_journalWritten = -1;
+	return true;
+}
+
+void Game::makeMove(const GameMove &move)
+{
+	if (move.isPass())
+	{
+		return;
+	}
+	if (move.from != GameMove::NO_SQUARE)
+	{
+		setSquareTag(move.from, 0);
+	}
+	setSquareTag(move.to, move.piece);
+	if (move.capture != GameMove::NO_SQUARE)
+	{
+		setSquareTag(move.capture, 0);
+	}
+	for (uint64_t bits = move.flips; bits; bits &= bits - 1)
+	{
+		setSquareTag(std::countr_zero(bits), move.piece);
+	}
+}
+
+void Game::unmakeMove(const GameMove &move)
+{
+	if (move.isPass())
+	{
+		return;
+	}
+	for (uint64_t bits = move.flips; bits; bits &= bits - 1)
+	{
+		setSquareTag(std::countr_zero(bits), move.captured);
+	}
+	if (move.capture != GameMove::NO_SQUARE)
+	{
+		setSquareTag(move.capture, move.captured);
+	}
+	setSquareTag(move.to, 0);
+	if (move.from != GameMove::NO_SQUARE)
+	{
+		setSquareTag(move.from, move.moved);
+	}
+}
+
+void Game::setSquareTag(int index, int tag)
+{
+	Grid *grid = getGrid();
+	ChessSquare *square = grid->getSquare(index % grid->getWidth(), index / grid->getWidth());
+	if (!square)
+	{
+		return;
+	}
+	square->destroyBit();
+	if (tag)
+	{
+		Bit *bit = pieceForTag(tag);
+		if (bit)
+		{
+			bit->setPosition(square->getPosition());
+			square->setBit(bit);
+		}
+	}
+}
+
+BoardSnapshot Game::snapshot()
+{
+	Grid *grid = getGrid();
+	BoardSnapshot snap(grid->getWidth() * grid->getHeight(), snapshotBitsPerCell());
+	grid->forEachSquare([&](ChessSquare *square, int x, int y) {
+		Bit *bit = square->bit();
+		if (bit)
+		{
+			snap.set(grid->getIndex(x, y), bit->gameTag());
+		}
+	});
+	snap.setSideToMove(getCurrentPlayer()->playerNumber());
+	return snap;
+}
+
 //
 // scan for mouse is temporarily in the actual game class
 // this will be moved to a higher up class when the squares have a heirarchy
@@ -108,6 +344,7 @@ void Game::endTurn()
 //
 void Game::scanForMouse()
 {
+	PROFILE_SCOPE("scanForMouse");
 	if (gameHasAI() && getCurrentPlayer()->isAIPlayer())
 	{
 		return;
@@ -119,9 +356,15 @@ void Game::scanForMouse()
 	mousePos.x -= ImGui::GetWindowPos().x;
 	mousePos.y -= ImGui::GetWindowPos().y;
 
+	// only the square under the mouse and the piece being dragged can be hit
 	Entity *entity = nullptr;
-	Grid* grid = getGrid();
-	grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
+	ChessSquare *square = getGrid()->getSquareAtPoint(mousePos);
+	if (_dragBit && _dragBit->isMouseOver(mousePos))
+	{
+		entity = _dragBit;
+	}
+	else if (square)
+	{
 		Bit *bit = square->bit();
 		if (bit && bit->isMouseOver(mousePos))
 		{
@@ -131,7 +374,7 @@ void Game::scanForMouse()
 		{
 			entity = square;
 		}
-	});
+	}
 	if (ImGui::IsMouseClicked(0))
 	{
 		mouseDown(mousePos, entity);
@@ -148,27 +391,22 @@ void Game::scanForMouse()
 
 void Game::findDropTarget(ImVec2 &pos)
 {
-	Grid* grid = getGrid();
-	grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-		if (square == _oldHolder)
-		{
-			return;
-		}
-		if (square->isMouseOver(pos))
-		{
-			if (_dropTarget && square != _dropTarget)
-			{
-				_dropTarget->willNotDropBit(_dragBit);
-				_dropTarget->setHighlighted(false);
-				_dropTarget = nullptr;
-			}
-			if (_oldHolder && square->canDropBitAtPoint(_dragBit, pos) && canBitMoveFromTo(*_dragBit, *_oldHolder, *square))
-			{
-				_dropTarget = square;
-				_dropTarget->setHighlighted(true);
-			}
-		}
-	});
+	ChessSquare *square = getGrid()->getSquareAtPoint(pos);
+	if (!square || square == _oldHolder || !square->isMouseOver(pos))
+	{
+		return;
+	}
+	if (_dropTarget && square != _dropTarget)
+	{
+		_dropTarget->willNotDropBit(_dragBit);
+		_dropTarget->setHighlighted(false);
+		_dropTarget = nullptr;
+	}
+	if (_oldHolder && square->canDropBitAtPoint(_dragBit, pos) && canBitMoveFromTo(*_dragBit, *_oldHolder, *square))
+	{
+		_dropTarget = square;
+		_dropTarget->setHighlighted(true);
+	}
 }
 
 //
@@ -177,39 +415,50 @@ void Game::findDropTarget(ImVec2 &pos)
 //
 void Game::drawFrame()
 {
+	PROFILE_SCOPE("drawFrame");
 	scanForMouse();
 
-	Grid* grid = getGrid();
-
-	// Paint squares
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		square->paintSprite();
-	});
-
-	// Paint stationary pieces
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		if (square->bit() && !square->bit()->getPickedUp() && !square->bit()->getMoving())
+	// one pass over the board, the queue puts the layers in order
+	_renderQueue.clear();
+	getGrid()->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
+		_renderQueue.add(square);
+		if (square->bit())
 		{
-			square->bit()->paintSprite();
+			_renderQueue.add(square->bit());
 		}
 	});
 
-	// Paint moving pieces
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		if (square->bit() && square->bit()->getMoving() && !square->bit()->getPickedUp())
-		{
-			square->bit()->update();
-			square->bit()->paintSprite();
-		}
-	});
+	_renderer.begin();
+	_renderQueue.paint(_renderer);
+	if (_gameOptions.showHints && hasHints())
+	{
+		drawHints(_renderer);
+	}
+	_renderer.end();
+}
 
-	// Paint picked up pieces
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		if (square->bit() && square->bit()->getPickedUp())
-		{
-			square->bit()->paintSprite();
-		}
-	});
+SearchLimits Game::hintSearchLimits() const
+{
+	SearchLimits limits;
+	limits.maxDepth = _gameOptions.AIMAXDepth;
+	limits.timeMs = HINT_TIME_MS;
+	// the hints run in slices too where the AI has to
+	limits.sliceUs = _gameOptions.AISliceUs;
+	return limits;
+}
+
+void Game::drawHint(BoardRenderer &renderer, Sprite &square, int score, int low, int high)
+{
+	// red for the worst move on offer through to green for the best, solid for a proven result
+	float t = high > low ? (float)(score - low) / (float)(high - low) : 1.0f;
+	float alpha = HINT_ALPHA;
+	if (score >= SEARCH_WIN - SEARCH_MAX_PLY || score <= -SEARCH_WIN + SEARCH_MAX_PLY)
+	{
+		t = score > 0 ? 1.0f : 0.0f;
+		alpha = HINT_PROVEN_ALPHA;
+	}
+	ImU32 color = ImGui::ColorConvertFloat4ToU32(ImVec4(1.0f - t, t, 0.0f, alpha));
+	renderer.addRect(square.getPosition(), square.getSize(), color);
 }
 
 void Game::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
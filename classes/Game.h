@@ -18,10 +18,16 @@
 #endif
 
 #include "Player.h"
-#include "Turn.h"
+#include "TurnHistory.h"
 #include "Bit.h"
 #include "BitHolder.h"
 #include "Grid.h"
+#include "Search.h"
+#include "BoardSnapshot.h"
+#include "GameRecord.h"
+#include "Journal.h"
+#include "BoardRenderer.h"
+#include "RenderQueue.h"
 
 
 const int AI_PLAYER = 1;
@@ -41,24 +47,58 @@ struct GameOptions
 	int score;
 	int AIDepthSearches;
 	int AIMAXDepth;
+	int AITimeLimitMs;
 	bool AIvsAI;
+	bool AIPonder;		// let the AI search while a human thinks
+	int AISliceUs;		// search on the render thread for this long each frame, 0 uses a worker thread
+	bool showHints;		// tint the squares by how good a move there is
 };
 
 class Game
 {
 public:
 	Game();
-	~Game();
+	virtual ~Game();
 
 	void startGame();
 
 	virtual void setUpBoard() = 0;
 
+	// name written to game records, the application creates games from it when loading
+	virtual const char *gameName() const = 0;
+
 	virtual void drawFrame();
 
 	// end the current game turn
 	virtual void endTurn();
 
+	// add a move to the history, games call this for every action before ending the turn
+	// the board must already show the move
+	void recordMove(const GameMove &move);
+	const TurnHistory &getHistory() const { return _history; }
+
+	// take back or replay one whole turn, only the squares the moves touched are updated
+	bool canUndo() const { return _history.canUndo(); }
+	bool canRedo() const { return _history.canRedo(); }
+	bool undo();
+	bool redo();
+	// jump straight to the board after ply moves of the history
+	void gotoPly(int ply);
+
+	// game records, loading expects a freshly set up board and keeps the history after it for redo
+	GameRecordHeader recordHeader();
+	bool saveRecord(const std::string &path);
+	bool loadRecord(GameRecordReader &reader, const GameRecordHeader &header);
+	// every finished turn is appended to the journal, nullptr turns it off
+	void setJournal(Journal *journal) { _journal = journal; _journalWritten = -1; }
+
+	// play a recorded move on the board or take it back again
+	// games override these to keep their own counters in step, and must call the base version
+	virtual void makeMove(const GameMove &move);
+	virtual void unmakeMove(const GameMove &move);
+	// a new piece for a gameTag, used to put pieces back on the board
+	virtual Bit *pieceForTag(int tag) { return nullptr; }
+
 	// Should return true if it is legal for the given bit to be moved from its current holder.
 	// Default implementation always returns true.
 	virtual bool canBitMoveFrom(Bit &bit, BitHolder &src) = 0;
@@ -95,16 +135,38 @@ public:
 	virtual void stopGame() = 0;
 	virtual bool gameHasAI();
 	virtual void updateAI();
+	// games that search in the background stop here when the board is about to change under them
+	virtual void stopAI() {}
+	// call after the AI has moved, true if a human is up next and the AI should think meanwhile
+	bool shouldPonder() { return _gameOptions.AIPonder && !_gameOptions.AIvsAI && !getCurrentPlayer()->isAIPlayer(); }
+	// what the AI's search is doing, false for games without a search engine
+	virtual bool searchStats(SearchStats &stats) const { return false; }
+	// games that can score every move for the hint overlay
+	virtual bool hasHints() { return false; }
+	// the hint scores are still being refined in the background
+	virtual bool hintsRunning() const { return false; }
+	// the hints were switched off, their worker has nothing left to do
+	virtual void stopHints() {}
 	virtual void pieceTaken(Bit *bit){};
 
 	virtual std::string initialStateString() = 0;
 	virtual std::string stateString() = 0;
 	virtual void setStateString(const std::string &s) = 0;
 
+	// fixed size binary copy of the board built from each piece's gameTag, cheap enough for hot paths
+	// the state strings above are only for display and export
+	virtual BoardSnapshot snapshot();
+	// bits needed to hold the largest gameTag this game uses
+	virtual int snapshotBitsPerCell() { return 2; }
+
 	void setNumberOfPlayers(unsigned int playerCount);
 	void setAIPlayer(unsigned int playerNumber);
 	virtual int getAIDepathSearches() { return _gameOptions.AIDepthSearches; };
 	virtual int getAIMAXDepth() { return _gameOptions.AIMAXDepth; };
+	// depth and time budget handed to the shared search for each AI move
+	SearchLimits aiSearchLimits() const { SearchLimits limits; limits.maxDepth = _gameOptions.AIMAXDepth; limits.timeMs = _gameOptions.AITimeLimitMs; limits.sliceUs = _gameOptions.AISliceUs; return limits; }
+	// depth and time budget for scoring the moves of one position for the hints
+	SearchLimits hintSearchLimits() const;
 
 	// mouse functions
 	void scanForMouse();
@@ -131,13 +193,22 @@ public:
 	Player *_winner;
 
 	std::vector<Player *> _players;
-	std::vector<Turn *> _turns;
+	TurnHistory _history;
 
 	std::string _lastMove;
 
 	GameOptions _gameOptions;
 
 protected:
+	// grid index of a holder, the square numbering used by GameMove and BoardSnapshot
+	int holderIndex(BitHolder &holder) { ChessSquare *square = static_cast<ChessSquare *>(&holder); return getGrid()->getIndex(square->getColumn(), square->getRow()); }
+	// replace whatever is on a square with a piece for tag, 0 leaves it empty
+	void setSquareTag(int index, int tag);
+	// queue the hint overlay, only called while hints are on
+	virtual void drawHints(BoardRenderer &renderer) {}
+	// tint a square for a move scoring score, where the unproven moves on offer score from low to high
+	void drawHint(BoardRenderer &renderer, Sprite &square, int score, int low, int high);
+
 	void mouseDown(ImVec2 &location, Entity *bit);
 	void mouseMoved(ImVec2 &location, Entity *bit);
 	void mouseUp(ImVec2 &location, Entity *bit);
@@ -151,4 +222,15 @@ protected:
 	BitHolder *_dropTarget;
 	BitHolder *_oldHolder;
 	bool _dragMoved;
+
+	// reused every frame so their storage is allocated once
+	RenderQueue _renderQueue;
+	BoardRenderer _renderer;
+
+private:
+	void writeJournal();
+
+	Journal *_journal;
+	int _journalWritten;	// moves in the journal file, -1 when it needs a new header
+	int _journalValid;		// how many of those still match the history
 };
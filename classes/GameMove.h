@@ -0,0 +1,95 @@
+#pragma once
+
+#include "BoardSnapshot.h"
+#include <cstdint>
+#include <bit>
+
+//
+// one action on the board, small enough to keep thousands of them in a flat array
+//
+// the move carries everything needed to play it forwards or backwards on a BoardSnapshot
+// without knowing which game it came from: what was lifted, what was put down, what was
+// captured and which discs were turned over. squares use the Grid index, y * width + x
+//
+struct GameMove
+{
+    static const uint16_t NO_SQUARE = 0xFFFF;
+
+    enum Flags : uint8_t
+    {
+        Pass = 1,       // the player had nothing to do
+        EndsTurn = 2,   // last action of the player's turn (a checkers jump chain is several actions)
+    };
+
+    uint16_t    from = NO_SQUARE;       // square a piece was lifted from, NO_SQUARE for a drop
+    uint16_t    to = NO_SQUARE;         // square a piece was put down on
+    uint16_t    capture = NO_SQUARE;    // square a captured piece was removed from
+    uint8_t     piece = 0;              // gameTag put down on to
+    uint8_t     moved = 0;              // gameTag lifted from from, differs from piece on a promotion
+    uint8_t     captured = 0;           // gameTag removed from capture, or the one the flips had before
+    uint8_t     player = 0;
+    uint8_t     flags = 0;
+    uint64_t    flips = 0;              // othello: squares turned over to piece
+
+    bool        isPass() const { return flags & Pass; }
+    bool        endsTurn() const { return flags & EndsTurn; }
+
+    static GameMove drop(int to, int piece, int player)
+    {
+        GameMove move;
+        move.to = (uint16_t)to;
+        move.piece = (uint8_t)piece;
+        move.player = (uint8_t)player;
+        return move;
+    }
+
+    static GameMove slide(int from, int to, int moved, int piece, int player)
+    {
+        GameMove move = drop(to, piece, player);
+        move.from = (uint16_t)from;
+        move.moved = (uint8_t)moved;
+        return move;
+    }
+
+    static GameMove pass(int player)
+    {
+        GameMove move;
+        move.player = (uint8_t)player;
+        move.flags = Pass;
+        return move;
+    }
+};
+
+//
+// play a move forwards on a snapshot
+//
+inline void applyMove(BoardSnapshot &board, const GameMove &move)
+{
+    if (!move.isPass()) {
+        if (move.from != GameMove::NO_SQUARE) board.set(move.from, 0);
+        board.set(move.to, move.piece);
+        if (move.capture != GameMove::NO_SQUARE) board.set(move.capture, 0);
+        for (uint64_t bits = move.flips; bits; bits &= bits - 1) {
+            board.set(std::countr_zero(bits), move.piece);
+        }
+    }
+    if (move.endsTurn()) {
+        board.setSideToMove(1 - move.player);
+    }
+}
+
+//
+// and backwards again
+//
+inline void unapplyMove(BoardSnapshot &board, const GameMove &move)
+{
+    if (!move.isPass()) {
+        for (uint64_t bits = move.flips; bits; bits &= bits - 1) {
+            board.set(std::countr_zero(bits), move.captured);
+        }
+        if (move.capture != GameMove::NO_SQUARE) board.set(move.capture, move.captured);
+        board.set(move.to, 0);
+        if (move.from != GameMove::NO_SQUARE) board.set(move.from, move.moved);
+    }
+    board.setSideToMove(move.player);
+}
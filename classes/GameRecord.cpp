@@ -0,0 +1,286 @@
+#include "GameRecord.h"
+#include "TurnHistory.h"
+#include <cstring>
+
+static const char RECORD_MAGIC[4] = { 'G', 'R', 'E', 'C' };
+static const uint8_t RECORD_VERSION = 1;
+static const size_t READ_BLOCK_SIZE = 64 * 1024;
+
+// move packet flags, the top bit tells a move apart from the 'G' starting the next header
+static const uint8_t PACKET_MOVE = 0x80;
+static const uint8_t PACKET_FROM = 0x01;
+static const uint8_t PACKET_CAPTURE = 0x02;
+static const uint8_t PACKET_FLIPS = 0x04;
+static const uint8_t PACKET_PASS = 0x08;
+static const uint8_t PACKET_ENDS_TURN = 0x10;
+static const uint8_t PACKET_PLAYER = 0x20;   // set for player 1
+
+static void putVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+void encodeRecordHeader(std::vector<uint8_t> &out, const GameRecordHeader &header)
+{
+    out.insert(out.end(), RECORD_MAGIC, RECORD_MAGIC + 4);
+    out.push_back(RECORD_VERSION);
+    putVarint(out, header.gameName.size());
+    out.insert(out.end(), header.gameName.begin(), header.gameName.end());
+    putVarint(out, header.width);
+    putVarint(out, header.height);
+    out.push_back((uint8_t)header.start.bitsPerCell());
+    putVarint(out, header.aiPlayers);
+    putVarint(out, header.maxDepth);
+    putVarint(out, header.timeMs);
+
+    // the starting board as (gap, tag) pairs for the occupied cells
+    const BoardSnapshot &start = header.start;
+    int occupied = 0;
+    for (int i = 0; i < start.cells(); i++) {
+        if (start.get(i)) occupied++;
+    }
+    putVarint(out, start.cells());
+    putVarint(out, occupied);
+    int last = -1;
+    for (int i = 0; i < start.cells(); i++) {
+        if (start.get(i)) {
+            putVarint(out, i - last - 1);
+            out.push_back((uint8_t)start.get(i));
+            last = i;
+        }
+    }
+    out.push_back((uint8_t)start.sideToMove());
+}
+
+void encodeRecordMove(std::vector<uint8_t> &out, const GameMove &move)
+{
+    uint8_t flags = PACKET_MOVE;
+    if (move.isPass()) flags |= PACKET_PASS;
+    if (move.endsTurn()) flags |= PACKET_ENDS_TURN;
+    if (move.player) flags |= PACKET_PLAYER;
+    if (!move.isPass()) {
+        if (move.from != GameMove::NO_SQUARE) flags |= PACKET_FROM;
+        if (move.capture != GameMove::NO_SQUARE) flags |= PACKET_CAPTURE;
+        if (move.flips) flags |= PACKET_FLIPS;
+    }
+    out.push_back(flags);
+    if (move.isPass()) {
+        return;
+    }
+    putVarint(out, move.to);
+    out.push_back(move.piece);
+    if (flags & PACKET_FROM) {
+        putVarint(out, move.from);
+        out.push_back(move.moved);
+    }
+    if (flags & PACKET_CAPTURE) {
+        putVarint(out, move.capture);
+    }
+    if (flags & PACKET_FLIPS) {
+        putVarint(out, move.flips);
+    }
+    if (flags & (PACKET_CAPTURE | PACKET_FLIPS)) {
+        out.push_back(move.captured);
+    }
+}
+
+bool saveGameRecord(const std::string &path, const GameRecordHeader &header, const TurnHistory &history)
+{
+    std::vector<uint8_t> out;
+    out.reserve(64 + history.size() * 4);
+    encodeRecordHeader(out, header);
+    for (int i = 0; i < history.size(); i++) {
+        encodeRecordMove(out, history.at(i));
+    }
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    return fclose(file) == 0 && ok;
+}
+
+GameRecordReader::GameRecordReader() : _file(nullptr), _pos(0), _end(0), _ply(0)
+{
+}
+
+GameRecordReader::~GameRecordReader()
+{
+    close();
+}
+
+bool GameRecordReader::open(const std::string &path)
+{
+    close();
+    _file = fopen(path.c_str(), "rb");
+    if (!_file) {
+        return false;
+    }
+    _buffer.resize(READ_BLOCK_SIZE);
+    _pos = _end = 0;
+    _ply = 0;
+    return true;
+}
+
+void GameRecordReader::close()
+{
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+    _pos = _end = 0;
+}
+
+bool GameRecordReader::fill()
+{
+    if (!_file) {
+        return false;
+    }
+    _end = fread(_buffer.data(), 1, _buffer.size(), _file);
+    _pos = 0;
+    return _end > 0;
+}
+
+bool GameRecordReader::peekByte(uint8_t &value)
+{
+    if (_pos == _end && !fill()) {
+        return false;
+    }
+    value = _buffer[_pos];
+    return true;
+}
+
+bool GameRecordReader::readByte(uint8_t &value)
+{
+    if (!peekByte(value)) {
+        return false;
+    }
+    _pos++;
+    return true;
+}
+
+bool GameRecordReader::readVarint(uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte;
+        if (!readByte(byte)) {
+            return false;
+        }
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GameRecordReader::nextGame(GameRecordHeader &header)
+{
+    GameMove skipped;
+    while (nextMove(skipped)) {
+    }
+
+    char magic[4];
+    uint8_t byte;
+    for (char &c : magic) {
+        if (!readByte(byte)) return false;
+        c = (char)byte;
+    }
+    uint8_t version;
+    if (std::memcmp(magic, RECORD_MAGIC, 4) != 0 || !readByte(version) || version != RECORD_VERSION) {
+        return false;
+    }
+
+    uint64_t length, width, height, aiPlayers, maxDepth, timeMs, cells, occupied;
+    uint8_t bitsPerCell;
+    if (!readVarint(length) || length > 255) {
+        return false;
+    }
+    header.gameName.resize((size_t)length);
+    for (char &c : header.gameName) {
+        if (!readByte(byte)) return false;
+        c = (char)byte;
+    }
+    if (!readVarint(width) || !readVarint(height) || !readByte(bitsPerCell) || !readVarint(aiPlayers) ||
+        !readVarint(maxDepth) || !readVarint(timeMs) || !readVarint(cells) || !readVarint(occupied)) {
+        return false;
+    }
+    // the snapshot would quietly shrink a board that doesn't fit, and then moves past its end
+    // would be out of range. a torn journal can hold anything here
+    if ((bitsPerCell != 1 && bitsPerCell != 2 && bitsPerCell != 4) || cells == 0 ||
+        cells * bitsPerCell > (uint64_t)BoardSnapshot::CAPACITY_BITS) {
+        return false;
+    }
+    header.width = (int)width;
+    header.height = (int)height;
+    header.aiPlayers = (int)aiPlayers;
+    header.maxDepth = (int)maxDepth;
+    header.timeMs = (int)timeMs;
+
+    header.start = BoardSnapshot((int)cells, bitsPerCell);
+    uint64_t cell = 0;
+    for (uint64_t i = 0; i < occupied; i++) {
+        uint64_t gap;
+        uint8_t tag;
+        if (!readVarint(gap) || !readByte(tag)) {
+            return false;
+        }
+        cell += gap;
+        if (cell < cells) header.start.set((int)cell, tag);
+        cell++;
+    }
+    uint8_t side;
+    if (!readByte(side)) {
+        return false;
+    }
+    header.start.setSideToMove(side);
+
+    _board = header.start;
+    _ply = 0;
+    return true;
+}
+
+bool GameRecordReader::nextMove(GameMove &move)
+{
+    uint8_t flags;
+    if (!peekByte(flags) || !(flags & PACKET_MOVE)) {
+        return false;
+    }
+    _pos++;
+
+    move = GameMove();
+    move.player = (flags & PACKET_PLAYER) ? 1 : 0;
+    if (flags & PACKET_PASS) move.flags |= GameMove::Pass;
+    if (flags & PACKET_ENDS_TURN) move.flags |= GameMove::EndsTurn;
+    if (!(flags & PACKET_PASS)) {
+        // a square past the end of the board is a damaged record, not a move
+        const uint64_t cells = (uint64_t)_board.cells();
+        uint64_t value;
+        if (!readVarint(value) || value >= cells || !readByte(move.piece)) return false;
+        move.to = (uint16_t)value;
+        if (flags & PACKET_FROM) {
+            if (!readVarint(value) || value >= cells || !readByte(move.moved)) return false;
+            move.from = (uint16_t)value;
+        }
+        if (flags & PACKET_CAPTURE) {
+            if (!readVarint(value) || value >= cells) return false;
+            move.capture = (uint16_t)value;
+        }
+        if (flags & PACKET_FLIPS) {
+            if (!readVarint(move.flips) || (cells < 64 && (move.flips >> cells) != 0)) return false;
+        }
+        if (flags & (PACKET_CAPTURE | PACKET_FLIPS)) {
+            if (!readByte(move.captured)) return false;
+        }
+    }
+
+    applyMove(_board, move);
+    _ply++;
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "GameMove.h"
+#include "BoardSnapshot.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class TurnHistory;
+
+//
+// compact binary game records
+//
+// a record is a header followed by one small packet per move, so a game in progress can be
+// appended to as it is played and several records can simply be concatenated in one file.
+//
+//   header: "GREC" version name width height bitsPerCell aiPlayers maxDepth timeMs start-board
+//   move:   flags byte (always has the top bit set) then only the fields the flags say are there
+//
+// numbers are LEB128 varints. nothing here knows about sprites, a reader replays a record
+// on a BoardSnapshot
+//
+struct GameRecordHeader
+{
+    std::string     gameName;
+    int             width = 0;
+    int             height = 0;
+    int             aiPlayers = 0;      // bit n set when player n is played by the AI
+    int             maxDepth = 0;
+    int             timeMs = 0;
+    BoardSnapshot   start;
+};
+
+// encoders, both append to out
+void encodeRecordHeader(std::vector<uint8_t> &out, const GameRecordHeader &header);
+void encodeRecordMove(std::vector<uint8_t> &out, const GameMove &move);
+
+// write a whole game, every recorded move including any that were undone
+bool saveGameRecord(const std::string &path, const GameRecordHeader &header, const TurnHistory &history);
+
+//
+// streaming reader, reads the file a block at a time and keeps the board of the current
+// record up to date as moves are read
+//
+class GameRecordReader
+{
+public:
+    GameRecordReader();
+    ~GameRecordReader();
+
+    bool            open(const std::string &path);
+    void            close();
+
+    // move on to the next record in the file, skipping what is left of the current one
+    bool            nextGame(GameRecordHeader &header);
+    // read the next move of the current record and play it on board(), false at the end of the record
+    bool            nextMove(GameMove &move);
+
+    const BoardSnapshot &board() const { return _board; }
+    int             ply() const { return _ply; }
+
+private:
+    bool            fill();
+    bool            peekByte(uint8_t &value);
+    bool            readByte(uint8_t &value);
+    bool            readVarint(uint64_t &value);
+
+    FILE                    *_file;
+    std::vector<uint8_t>    _buffer;
+    size_t                  _pos;
+    size_t                  _end;
+    BoardSnapshot           _board;
+    int                     _ply;
+};
@@ -0,0 +1,18 @@
+#include "Gomoku.h"
+
+// the whole move, including the forcing-sequence search, has to come back inside a second
+static const int AI_TIME_LIMIT_MS = 800;
+
+Gomoku::Gomoku(int width, int height, int winLength) : TicTacToe(width, height, winLength)
+{
+}
+
+Gomoku::~Gomoku()
+{
+}
+
+void Gomoku::setUpBoard()
+{
+    TicTacToe::setUpBoard();
+    _gameOptions.AITimeLimitMs = AI_TIME_LIMIT_MS;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "TicTacToe.h"
+
+//
+// five in a row on a 15x15 board, the m,n,k generalisation of tic tac toe
+// the rules and the AI all come from TicTacToe, the bigger board just gets a bigger time budget
+//
+class Gomoku : public TicTacToe
+{
+public:
+    Gomoku(int width = 15, int height = 15, int winLength = 5);
+    ~Gomoku();
+
+    void        setUpBoard() override;
+    const char *gameName() const override { return "Gomoku"; }
+};
@@ -1,42 +1,36 @@
 #include "Grid.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
 
-Grid::Grid(int width, int height) : _width(width), _height(height)
+Grid::Grid(int width, int height) : _width(width), _height(height), _origin(0, 0), _squareSize(0)
 {
-    // Initialize 2D vectors
-    _squares.resize(height);
-    _enabled.resize(height);
+    const int count = width * height;
+    _squares.reset(new ChessSquare[count]);
 
-    for (int y = 0; y < height; y++) {
-        _squares[y].resize(width);
-        _enabled[y].resize(width);
-
-        for (int x = 0; x < width; x++) {
-            _squares[y][x] = new ChessSquare();
-            _enabled[y][x] = true; // All squares enabled by default
-        }
+    // All squares enabled by default
+    _enabled.assign((count + 63) / 64, 0);
+    _enabledIndices.resize(count);
+    for (int index = 0; index < count; index++) {
+        _enabled[index >> 6] |= 1ull << (index & 63);
+        _enabledIndices[index] = index;
     }
 }
 
 Grid::~Grid()
 {
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            delete _squares[y][x];
-        }
-    }
 }
 
 ChessSquare* Grid::getSquare(int x, int y)
 {
     if (!isValid(x, y)) return nullptr;
-    return _squares[y][x];
+    return &_squares[getIndex(x, y)];
 }
 
 ChessSquare* Grid::getSquareByIndex(int index)
 {
-    int x, y;
-    getCoordinates(index, x, y);
-    return getSquare(x, y);
+    if (index < 0 || index >= _width * _height) return nullptr;
+    return &_squares[index];
 }
 
 bool Grid::isValid(int x, int y) const
@@ -47,13 +41,22 @@ bool Grid::isValid(int x, int y) const
 bool Grid::isEnabled(int x, int y) const
 {
     if (!isValid(x, y)) return false;
-    return _enabled[y][x];
+    return isEnabledIndex(getIndex(x, y));
 }
 
 void Grid::setEnabled(int x, int y, bool enabled)
 {
-    if (isValid(x, y)) {
-        _enabled[y][x] = enabled;
+    if (!isValid(x, y) || isEnabled(x, y) == enabled) return;
+
+    const int index = getIndex(x, y);
+    _enabled[index >> 6] ^= 1ull << (index & 63);
+
+    // squares are only switched on and off while a board is set up, rebuilding is fine
+    _enabledIndices.clear();
+    for (int word = 0; word < (int)_enabled.size(); word++) {
+        for (uint64_t bits = _enabled[word]; bits; bits &= bits - 1) {
+            _enabledIndices.push_back(word * 64 + std::countr_zero(bits));
+        }
     }
 }
 
@@ -63,6 +66,15 @@ void Grid::getCoordinates(int index, int& x, int& y) const
     y = index / _width;
 }
 
+ChessSquare* Grid::getSquareAtPoint(const ImVec2& point)
+{
+    if (_squareSize <= 0) return nullptr;
+    int x = (int)std::floor((point.x - _origin.x) / _squareSize);
+    int y = (int)std::floor((point.y - _origin.y) / _squareSize);
+    if (!isEnabled(x, y)) return nullptr;
+    return &_squares[getIndex(x, y)];
+}
+
 // Directional helpers
 ChessSquare* Grid::getFL(int x, int y)
 {
@@ -149,27 +161,6 @@ bool Grid::areConnected(int fromX, int fromY, int toX, int toY)
     return false;
 }
 
-// Iterator support
-void Grid::forEachSquare(std::function<void(ChessSquare*, int x, int y)> func)
-{
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            func(_squares[y][x], x, y);
-        }
-    }
-}
-
-void Grid::forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func)
-{
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                func(_squares[y][x], x, y);
-            }
-        }
-    }
-}
-
 // Initialize squares
 void Grid::initializeSquares(float squareSize, const char* spriteName)
 {
@@ -183,8 +174,12 @@ void Grid::initializeSquares(float squareSize, const char* spriteName)
 void Grid::initializeSquare(int x, int y, float squareSize, const char* spriteName)
 {
     if (isValid(x, y)) {
-        ImVec2 position(squareSize * x + squareSize/2, squareSize * y + squareSize/2);
-        _squares[y][x]->initHolder(position, spriteName, x, y);
+        _origin = ImVec2(squareSize/2, squareSize/2);
+        _squareSize = squareSize;
+        ImVec2 position(_origin.x + squareSize * x, _origin.y + squareSize * y);
+        ChessSquare &square = _squares[getIndex(x, y)];
+        square.initHolder(position, spriteName, x, y);
+        square.setSize(squareSize, squareSize);
     }
 }
 
@@ -193,16 +188,12 @@ std::string Grid::getStateString() const
 {
     std::string state;
 
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                Bit* bit = _squares[y][x]->bit();
-                if (bit) {
-                    state += std::to_string(bit->gameTag());
-                } else {
-                    state += '0';
-                }
-            }
+    for (int index : _enabledIndices) {
+        Bit* bit = _squares[index].bit();
+        if (bit) {
+            state += std::to_string(bit->gameTag());
+        } else {
+            state += '0';
         }
     }
 
@@ -211,19 +202,13 @@ std::string Grid::getStateString() const
 
 void Grid::setStateString(const std::string& state)
 {
-    size_t index = 0;
-
-    for (int y = 0; y < _height && index < state.length(); y++) {
-        for (int x = 0; x < _width && index < state.length(); x++) {
-            if (_enabled[y][x]) {
-                char pieceChar = state[index++];
+    size_t count = std::min(state.length(), _enabledIndices.size());
 
-                // Clear existing piece
-                _squares[y][x]->destroyBit();
+    for (size_t i = 0; i < count; i++) {
+        // Clear existing piece
+        _squares[_enabledIndices[i]].destroyBit();
 
-                // This method just sets the state - games need to create their own pieces
-                // when loading from state string based on the piece type
-            }
-        }
+        // This method just sets the state - games need to create their own pieces
+        // when loading from state string based on the piece type
     }
 }
\ No newline at end of file
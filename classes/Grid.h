@@ -3,9 +3,17 @@
 #include "ChessSquare.h"
 #include <vector>
 #include <unordered_map>
-#include <functional>
+#include <memory>
+#include <span>
+#include <cstdint>
 #include <string>
 
+//
+// the squares live in one array in index order (y * width + x), so a sweep over the board
+// walks memory front to back. the enabled squares are a bitmask, with their indices kept in
+// a list as well for the per-frame sweeps that only want those
+//
+
 class Grid
 {
 public:
@@ -25,6 +33,10 @@ public:
     int getIndex(int x, int y) const { return y * _width + x; }
     void getCoordinates(int index, int& x, int& y) const;
 
+    // Picking, the enabled square whose cell holds a point in window coordinates, nullptr if
+    // the point is off the board. uses the layout from initializeSquare instead of a search
+    ChessSquare* getSquareAtPoint(const ImVec2& point);
+
     // Directional helpers (built into Grid)
     ChessSquare* getFL(int x, int y);  // front-left (up-left diagonal)
     ChessSquare* getFR(int x, int y);  // front-right (up-right diagonal)
@@ -49,9 +61,26 @@ public:
     std::vector<ChessSquare*> getConnectedSquares(int x, int y);
     bool areConnected(int fromX, int fromY, int toX, int toY);
 
-    // Iterator support
-    void forEachSquare(std::function<void(ChessSquare*, int x, int y)> func);
-    void forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func);
+    // Iterator support, func is called as func(ChessSquare*, int x, int y)
+    template <typename Func>
+    void forEachSquare(Func &&func)
+    {
+        ChessSquare *square = _squares.get();
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++) {
+                func(square++, x, y);
+            }
+        }
+    }
+    template <typename Func>
+    void forEachEnabledSquare(Func &&func)
+    {
+        for (int index : _enabledIndices) {
+            func(&_squares[index], index % _width, index / _width);
+        }
+    }
+    // grid indices of the enabled squares, in index order
+    std::span<const int> getEnabledIndices() const { return _enabledIndices; }
 
     // Initialize squares with positions and sprites
     void initializeSquares(float squareSize, const char* spriteName);
@@ -62,9 +91,16 @@ public:
     void setStateString(const std::string& state);
 
 private:
-    std::vector<std::vector<ChessSquare*>> _squares;
-    std::vector<std::vector<bool>> _enabled;
+    bool isEnabledIndex(int index) const { return (_enabled[index >> 6] >> (index & 63)) & 1; }
+
+    // squares can't be copied or moved, so the array is sized once
+    std::unique_ptr<ChessSquare[]> _squares;
+    std::vector<uint64_t> _enabled;
+    std::vector<int> _enabledIndices;
     std::unordered_map<int, std::vector<int>> _connections;
     int _width;
     int _height;
+    // where initializeSquare put square 0,0 and how big the squares are
+    ImVec2 _origin;
+    float _squareSize;
 };
\ No newline at end of file
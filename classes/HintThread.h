@@ -0,0 +1,287 @@
+#pragma once
+
+#include "Search.h"
+#include "AllocTracker.h"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//
+// scores every move of a position on a worker thread, for the hint overlay
+//
+// each move is searched on its own with iterative deepening and the whole set of scores is
+// handed over after every depth, so the overlay sharpens while it is on screen. the scores
+// stay in a cache keyed by the position hash, drawing a position again is a lookup and going
+// back to it later picks up the finished scores. the worker has a Searcher of its own so it
+// never shares a table with the AI
+//
+// like SearchThread, limits.sliceUs > 0 does the work on the caller's thread instead, for
+// builds with no thread to spare. each request() for the position then scores for sliceUs
+// microseconds and the next one carries on from there
+//
+// generateMoves may leave out moves the search has no use for, so a position with hints also
+// lists every legal move with generateAllMoves(std::vector<Move> &moves)
+//
+template <typename P>
+concept HintPosition = SearchPosition<P> && requires(const P &position, std::vector<typename P::Move> &moves) {
+    { position.generateAllMoves(moves) };
+};
+
+template <HintPosition P>
+class HintThread
+{
+public:
+    using Move = typename P::Move;
+
+    struct MoveHint
+    {
+        Move    move;
+        int     score;      // for the side to move in the position
+    };
+
+    struct Hints
+    {
+        std::vector<MoveHint> moves;
+        int     depth = 0;      // deepest search every move has had
+        bool    done = false;   // no more refining will happen
+
+        // the lowest and highest scores, for scaling the overlay. proven wins and losses get
+        // colours of their own and would squash the rest of the scale, so they are left out.
+        // low ends up above high when every score is proven
+        void range(int &low, int &high) const
+        {
+            low = SEARCH_INFINITY;
+            high = -SEARCH_INFINITY;
+            for (const MoveHint &hint : moves) {
+                if (!proven(hint.score)) {
+                    low = std::min(low, hint.score);
+                    high = std::max(high, hint.score);
+                }
+            }
+        }
+    };
+
+    static const size_t TABLE_ENTRIES = 1 << 16;
+    static const size_t CACHE_LIMIT = 4096;
+
+    HintThread() : _searcher(TABLE_ENTRIES), _key(0), _stop(false), _running(false), _sliceUs(0), _searching(false), _allProven(true), _shownKey(0) {}
+    ~HintThread() { cancel(); }
+
+    // start scoring position unless that is already happening or done. limits cap the depth
+    // and the time spent on the whole position. call once a frame while the hints are shown,
+    // a sliced scoring only moves on inside this call
+    void request(const P &position, const SearchLimits &limits)
+    {
+        const uint64_t key = position.hash();
+        if (running() && key == _key) {
+            if (_sliceUs > 0) {
+                ALLOC_SCOPE("hint search");
+                step();
+            }
+            return;
+        }
+        cancel();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto found = _cache.find(key);
+            if (found != _cache.end() && found->second.done) {
+                return;
+            }
+        }
+        _searcher.clearStop();
+        _stop.store(false, std::memory_order_relaxed);
+        _key = key;
+        _sliceUs = limits.sliceUs;
+        begin(position, limits);
+        _running.store(true, std::memory_order_relaxed);
+        if (_sliceUs > 0) {
+            ALLOC_SCOPE("hint search");
+            step();
+            return;
+        }
+        _thread = std::thread([this] {
+            Tracer::setThreadName("hints");
+            ALLOC_SCOPE("hint search");
+            step();
+        });
+    }
+
+    // the worker is still refining a position
+    bool running() const { return _running.load(std::memory_order_acquire); }
+
+    // the latest scores for position, nullptr if there are none yet. they are only copied out
+    // of the cache when the worker has published new ones, so drawing them every frame does not
+    // allocate. the pointer is good until the next find()
+    const Hints *find(const P &position)
+    {
+        const uint64_t key = position.hash();
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto found = _cache.find(key);
+        if (found == _cache.end() || found->second.moves.empty()) {
+            return nullptr;
+        }
+        const Hints &cached = found->second;
+        if (key != _shownKey || cached.depth != _shown.depth || cached.done != _shown.done) {
+            _shown = cached;
+            _shownKey = key;
+        }
+        return &_shown;
+    }
+
+    void cancel()
+    {
+        if (_thread.joinable()) {
+            _stop.store(true, std::memory_order_relaxed);
+            _searcher.stop();
+            _thread.join();
+        }
+        // a sliced scoring is simply dropped, every finished depth is in the cache already and
+        // the next begin() starts the searcher afresh
+        _running.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    static bool proven(int score) { return score >= SEARCH_WIN - SEARCH_MAX_PLY || score <= -SEARCH_WIN + SEARCH_MAX_PLY; }
+
+    void begin(const P &position, const SearchLimits &limits)
+    {
+        _position.emplace(position);
+        _limits = limits;
+        _deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.timeMs);
+        _hints = Hints();
+        _moves.clear();
+        _scored.clear();
+        _searching = false;
+        _allProven = true;
+        int terminalScore;
+        if (!_position->isTerminal(terminalScore)) {
+            _position->generateAllMoves(_moves);
+        }
+    }
+
+    //
+    // score moves until the position is done with or, sliced, the slice is over. the depth in
+    // progress is _hints.depth + 1 and _scored holds its moves so far, the move after them is
+    // being searched when _searching is set
+    //
+    void step()
+    {
+        using namespace std::chrono;
+        const auto sliceEnd = steady_clock::now() + microseconds(_sliceUs);
+        P &position = *_position;
+        TRACE_SCOPE_VALUE("hint depth", "depth", _hints.depth + 1);
+        while (true) {
+            const int depth = _hints.depth + 1;
+            if (_moves.empty() || depth > _limits.maxDepth) {
+                finish(true);
+                return;
+            }
+            if (_scored.size() == _moves.size()) {
+                _hints.moves.swap(_scored);
+                _hints.depth = depth;
+                _scored.clear();
+                publish(_key, _hints, false);
+                if (_allProven) {
+                    finish(true);
+                    return;
+                }
+                _allProven = true;
+                continue;
+            }
+
+            int score = 0;
+            bool complete = true;
+            if (_searching) {
+                int sliceLeft = 0;
+                if (_sliceUs > 0) {
+                    sliceLeft = (int)duration_cast<microseconds>(sliceEnd - steady_clock::now()).count();
+                    if (sliceLeft <= 0) {
+                        return;
+                    }
+                }
+                if (!_searcher.step(sliceLeft)) {
+                    return;
+                }
+                _searching = false;
+                const SearchResult<Move> &result = _searcher.result();
+                score = -result.score;
+                // a proven score ends the search early without it running out of time
+                complete = result.depth == depth - 1 || (result.depth > 0 && proven(result.score));
+            } else {
+                _move = _moves[_scored.size()];
+                position.makeMove(_move);
+                int terminalScore;
+                if (position.isTerminal(terminalScore)) {
+                    score = -terminalScore;
+                } else if (depth == 1) {
+                    score = -position.evaluate();
+                } else {
+                    SearchLimits childLimits = _limits;
+                    childLimits.maxDepth = depth - 1;
+                    childLimits.timeMs = (int)duration_cast<milliseconds>(_deadline - steady_clock::now()).count();
+                    if (childLimits.timeMs > 0) {
+                        _searcher.begin(position, childLimits);
+                        _searching = true;
+                        continue;
+                    }
+                    complete = false;
+                }
+            }
+            position.unmakeMove(_move);
+            if (!complete || _stop.load(std::memory_order_relaxed)) {
+                finish(!_stop.load(std::memory_order_relaxed));
+                return;
+            }
+            _allProven = _allProven && proven(score);
+            _scored.push_back({ _move, score });
+            if (_sliceUs > 0 && steady_clock::now() >= sliceEnd) {
+                return;
+            }
+        }
+    }
+
+    void finish(bool done)
+    {
+        publish(_key, _hints, done);
+        _running.store(false, std::memory_order_release);
+    }
+
+    // a deeper set of scores replaces the cached one, a cancelled worker never makes it shallower
+    void publish(uint64_t key, const Hints &hints, bool done)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cache.size() >= CACHE_LIMIT && _cache.find(key) == _cache.end()) {
+            _cache.clear();
+        }
+        Hints &entry = _cache[key];
+        if (hints.depth > entry.depth) {
+            entry.moves = hints.moves;
+            entry.depth = hints.depth;
+        }
+        entry.done = entry.done || done;
+    }
+
+    Searcher<P>         _searcher;
+    uint64_t            _key;           // position the worker was started on
+    std::atomic<bool>   _stop;
+    std::atomic<bool>   _running;
+    int                 _sliceUs;       // 0 when the work is done on _thread
+    std::thread         _thread;
+    // the work in progress, only touched by whoever is running step()
+    std::optional<P>    _position;
+    SearchLimits        _limits;
+    std::chrono::steady_clock::time_point _deadline;
+    Hints               _hints;         // every depth finished so far
+    std::vector<Move>   _moves;
+    std::vector<MoveHint> _scored;      // the depth in progress
+    Move                _move;          // played on _position while the searcher works on it
+    bool                _searching;
+    bool                _allProven;
+    mutable std::mutex  _mutex;
+    std::unordered_map<uint64_t, Hints> _cache;
+    Hints               _shown;         // the game thread's copy of the last scores found
+    uint64_t            _shownKey;
+};
@@ -0,0 +1,112 @@
+#include "Journal.h"
+#include "Trace.h"
+#include <chrono>
+
+// how long the writer lets moves pile up before writing them together
+static const std::chrono::milliseconds BATCH_DELAY(50);
+
+Journal::Journal() : _file(nullptr), _truncate(false), _stopping(false)
+{
+    _pending.reserve(4096);
+}
+
+Journal::~Journal()
+{
+    close();
+}
+
+bool Journal::open(const std::string &path)
+{
+    close();
+    _file = fopen(path.c_str(), "ab");
+    if (!_file) {
+        return false;
+    }
+    _path = path;
+    _stopping = false;
+    _writer = std::thread(&Journal::run, this);
+    return true;
+}
+
+void Journal::close()
+{
+    if (_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_one();
+        _writer.join();
+    }
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+void Journal::restart(const GameRecordHeader &header)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending.clear();
+        encodeRecordHeader(_pending, header);
+        _truncate = true;
+    }
+    _wake.notify_one();
+}
+
+void Journal::append(const GameMove &move)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        encodeRecordMove(_pending, move);
+    }
+    _wake.notify_one();
+}
+
+void Journal::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending.clear();
+        _truncate = true;
+    }
+    _wake.notify_one();
+}
+
+void Journal::run()
+{
+    Tracer::setThreadName("journal writer");
+    std::vector<uint8_t> writing;
+    writing.reserve(_pending.capacity());
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _wake.wait(lock, [this] { return _stopping || _truncate || !_pending.empty(); });
+        // the first move of a batch waits a moment for the others
+        if (!_stopping) {
+            _wake.wait_for(lock, BATCH_DELAY, [this] { return _stopping; });
+        }
+        bool truncate = _truncate;
+        _truncate = false;
+        writing.swap(_pending);
+        lock.unlock();
+
+        TRACE_SCOPE("journal write");
+        if (truncate && _file) {
+            _file = freopen(_path.c_str(), "wb", _file);
+        }
+        if (_file && !writing.empty()) {
+            fwrite(writing.data(), 1, writing.size(), _file);
+        }
+        if (_file) {
+            fflush(_file);
+        }
+        writing.clear();
+
+        lock.lock();
+        if (_stopping && !_truncate && _pending.empty()) {
+            break;
+        }
+    }
+}
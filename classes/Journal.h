@@ -0,0 +1,47 @@
+#pragma once
+
+#include "GameRecord.h"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// autosave journal of the game in progress
+//
+// the journal file is an ordinary game record (see GameRecord.h) that grows a few bytes per
+// turn. the game thread only encodes into a memory buffer, a writer thread batches whatever has
+// piled up and writes and flushes it, so the frame never waits on the disk. if the app dies the
+// file holds every finished turn and is loaded back like any other record
+//
+class Journal
+{
+public:
+    Journal();
+    ~Journal();
+
+    // start the writer, the file is kept as it is until the first restart()
+    bool            open(const std::string &path);
+    // write everything still queued and stop the writer
+    void            close();
+
+    // replace the file's contents with a new record
+    void            restart(const GameRecordHeader &header);
+    void            append(const GameMove &move);
+    // empty the file, there is nothing left to restore
+    void            clear();
+
+private:
+    void            run();
+
+    std::string             _path;
+    FILE                    *_file;
+    std::thread             _writer;
+    std::mutex              _mutex;
+    std::condition_variable _wake;
+    std::vector<uint8_t>    _pending;       // encoded by the game thread, waiting to be written
+    bool                    _truncate;      // start the file over before writing _pending
+    bool                    _stopping;
+};
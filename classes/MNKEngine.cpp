@@ -0,0 +1,159 @@
+#include "MNKEngine.h"
+
+static const int VCF_DEPTH = 12;
+static const int MAX_FOURS = 64;
+
+MNKEngine::MNKEngine(int width, int height, int winLength)
+    : _position(width, height, winLength), _phase(Phase::Done), _deadline(0), _stop(false), _nodes(0), _aborted(false), _firstFour(-1)
+{
+}
+
+bool MNKEngine::outOfTime()
+{
+    if (_stop.load(std::memory_order_relaxed) ||
+        std::chrono::steady_clock::now().time_since_epoch().count() >= _deadline.load(std::memory_order_relaxed)) {
+        _aborted = true;
+    }
+    return _aborted;
+}
+
+void MNKEngine::setTimeLimit(int timeMs)
+{
+    // the threat search keeps its quarter, the searcher holds on to the limit if it has not started yet
+    _deadline.store((std::chrono::steady_clock::now() + std::chrono::milliseconds(timeMs / 4)).time_since_epoch().count());
+    _searcher.setTimeLimit(timeMs);
+}
+
+//
+// victory by continuous fours: the attacker keeps making moves the defender must answer
+// until one of them leaves two winning cells at once
+//
+bool MNKEngine::vcf(int attacker, int depth)
+{
+    const int defender = 3 - attacker;
+    if (_position.findWinningCell(attacker) >= 0) return true;
+    if (depth == 0) return false;
+    if (_position.findWinningCell(defender) >= 0) return false;
+    if ((++_nodes & 1023) == 0 && outOfTime()) return false;
+    if (_aborted) return false;
+
+    int fours[MAX_FOURS];
+    int count = 0;
+    for (int c : _position.candidates()) {
+        if (count < MAX_FOURS && _position.makesFour(c, attacker)) {
+            fours[count++] = c;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        int c = fours[i];
+        _position.place(c, attacker);
+        int threats[2];
+        int n = _position.winningCellsThrough(c, attacker, threats, 2);
+        bool win = n >= 2;
+        if (n == 1) {
+            _position.place(threats[0], defender);
+            win = !_position.hasWon(defender) && vcf(attacker, depth - 1);
+            _position.remove(threats[0]);
+        }
+        _position.remove(c);
+        if (win) {
+            // overwritten on the way back up, so it ends up holding the first four
+            _firstFour = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+int MNKEngine::findForcedWin(int player, int maxDepth)
+{
+    if (_position.findWinningCell(3 - player) >= 0) return -1;
+    int win = _position.findWinningCell(player);
+    if (win >= 0) return win;
+    _firstFour = -1;
+    return vcf(player, maxDepth) ? _firstFour : -1;
+}
+
+//
+// a move the quick checks settled on, without a search behind it
+//
+static MNKEngine::Result immediateResult(int cell)
+{
+    MNKEngine::Result result;
+    result.bestMove.cell = cell;
+    result.hasMove = true;
+    result.pv.add(result.bestMove);
+    return result;
+}
+
+//
+// moves that need no search: the center of an empty board, a win, a block, or the first four
+// of a forced win
+//
+int MNKEngine::threatMove()
+{
+    const int player = _position.sideToMove();
+    if (_position.stoneCount() == 0) return _position.centerCell();
+    int cell = _position.findWinningCell(player);
+    if (cell >= 0) return cell;
+    cell = _position.findWinningCell(3 - player);
+    if (cell >= 0) return cell;
+    return findForcedWin(player, VCF_DEPTH);
+}
+
+MNKEngine::Result MNKEngine::search(const MNKPosition &position, const SearchLimits &limits)
+{
+    begin(position, limits);
+    while (!step(0)) {
+    }
+    return _result;
+}
+
+void MNKEngine::begin(const MNKPosition &position, const SearchLimits &limits)
+{
+    _position = position;
+    _limits = limits;
+    _result = Result();
+    _phase = Phase::Threats;
+    // the threat search gets a quarter of the budget, the full search whatever is left
+    _start = std::chrono::steady_clock::now();
+    _deadline.store((_start + std::chrono::milliseconds(limits.timeMs / 4)).time_since_epoch().count());
+    _nodes = 0;
+    _aborted = false;
+}
+
+bool MNKEngine::step(int sliceUs)
+{
+    if (_phase == Phase::Threats) {
+        if (_position.isFull() || _stop.load(std::memory_order_relaxed)) {
+            _phase = Phase::Done;
+            return true;
+        }
+        // the threat search can't be resumed, in slices it gets the first one and no more
+        if (sliceUs > 0) {
+            auto sliceEnd = (std::chrono::steady_clock::now() + std::chrono::microseconds(sliceUs)).time_since_epoch().count();
+            _deadline.store(std::min(_deadline.load(), sliceEnd));
+        }
+        int cell = threatMove();
+        if (cell >= 0) {
+            _result = immediateResult(cell);
+            _phase = Phase::Done;
+            return true;
+        }
+
+        SearchLimits remaining = _limits;
+        int spent = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start).count();
+        remaining.timeMs = std::max(1, _limits.timeMs - spent);
+        _searcher.begin(_position, remaining);
+        _phase = Phase::Search;
+        if (sliceUs > 0) {
+            return false;
+        }
+    }
+    if (_phase == Phase::Search && _searcher.step(sliceUs)) {
+        _result = _searcher.result();
+        _phase = Phase::Done;
+    }
+    return _phase == Phase::Done;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "MNKPosition.h"
+#include "Search.h"
+#include <atomic>
+#include <chrono>
+
+//
+// AI for m,n,k games
+// before handing the position to the shared alpha-beta search it takes immediate wins,
+// blocks immediate losses and runs a threat-space search for forced wins
+//
+class MNKEngine
+{
+public:
+    MNKEngine(int width, int height, int winLength);
+
+    using Result = SearchResult<MNKPosition::Move>;
+
+    // pick a move for the side to move in position within the limits, the same calls as a
+    // Searcher so SearchThread can run either
+    Result      search(const MNKPosition &position, const SearchLimits &limits);
+    // or a slice at a time, see Searcher::begin
+    void        begin(const MNKPosition &position, const SearchLimits &limits);
+    bool        step(int sliceUs = 0);
+    const Result &result() const { return _result; }
+    void        stop() { _stop.store(true, std::memory_order_relaxed); _searcher.stop(); }
+    void        clearStop() { _stop.store(false, std::memory_order_relaxed); _searcher.clearStop(); }
+    SearchStats stats() const { return _searcher.stats(); }
+    // a running search gets timeMs from now, see Searcher::setTimeLimit
+    void        setTimeLimit(int timeMs);
+
+    // threat-space search: returns the first move of a forced win made only of four-threats, or -1
+    int         findForcedWin(int player, int maxDepth);
+
+private:
+    bool        vcf(int attacker, int depth);
+    bool        outOfTime();
+    int         threatMove();
+
+    MNKPosition             _position;
+    Searcher<MNKPosition>   _searcher;
+
+    enum class Phase { Threats, Search, Done };
+    Phase       _phase;
+    SearchLimits _limits;
+    Result      _result;
+    std::chrono::steady_clock::time_point _start;
+
+    std::atomic<std::chrono::steady_clock::rep> _deadline;     // for the threat search
+    std::atomic<bool> _stop;
+    long long   _nodes;
+    bool        _aborted;
+    int         _firstFour;
+};
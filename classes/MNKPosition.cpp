@@ -0,0 +1,328 @@
+#include "MNKPosition.h"
+#include <algorithm>
+
+static const int CANDIDATE_RADIUS = 2;     // empty cells this close to a stone are worth looking at
+static const int MAX_ORDERED = 512;        // enough for a 19x19 board
+
+MNKPosition::MNKPosition(int width, int height, int winLength)
+    : _width(width), _height(height), _winLength(winLength), _stones(0), _side(1), _score(0), _hash(0)
+{
+    _completed[0] = _completed[1] = 0;
+
+    // a window with n stones of one player is worth 8^(n-1), capped so the sums stay well below SEARCH_WIN
+    _weights.resize(_winLength + 2);
+    _weights[0] = 0;
+    for (int n = 1; n < (int)_weights.size(); n++) {
+        _weights[n] = 1 << std::min(3 * (n - 1), 18);
+    }
+
+    const int cellCount = _width * _height;
+    _zobrist.resize(cellCount * 2 + 1);
+    for (int i = 0; i < (int)_zobrist.size(); i++) {
+        _zobrist[i] = mixHash(0x4D4E4B00ull + i);
+    }
+
+    buildWindows();
+    clear();
+}
+
+void MNKPosition::buildWindows()
+{
+    const int dirs[4][2] = { {1,0}, {0,1}, {1,1}, {-1,1} };
+    const int cellCount = _width * _height;
+
+    _windows.clear();
+    for (int d = 0; d < 4; d++) {
+        int dx = dirs[d][0], dy = dirs[d][1];
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++) {
+                int ex = x + dx * (_winLength - 1);
+                int ey = y + dy * (_winLength - 1);
+                if (ex < 0 || ex >= _width || ey < 0 || ey >= _height) continue;
+                _windows.push_back({ y * _width + x, dy * _width + dx });
+            }
+        }
+    }
+
+    // invert the window list so each cell knows which windows run through it
+    std::vector<int> perCell(cellCount, 0);
+    for (int w = 0; w < (int)_windows.size(); w++) {
+        for (int i = 0; i < _winLength; i++) {
+            perCell[windowCell(w, i)]++;
+        }
+    }
+    _cellWindowStart.assign(cellCount + 1, 0);
+    for (int c = 0; c < cellCount; c++) {
+        _cellWindowStart[c + 1] = _cellWindowStart[c] + perCell[c];
+    }
+    _cellWindows.assign(_cellWindowStart[cellCount], 0);
+    std::fill(perCell.begin(), perCell.end(), 0);
+    for (int w = 0; w < (int)_windows.size(); w++) {
+        for (int i = 0; i < _winLength; i++) {
+            int c = windowCell(w, i);
+            _cellWindows[_cellWindowStart[c] + perCell[c]++] = w;
+        }
+    }
+}
+
+void MNKPosition::clear()
+{
+    const int cellCount = _width * _height;
+    _cells.assign(cellCount, 0);
+    _counts.assign(_windows.size() * 2, 0);
+    _near.assign(cellCount, 0);
+    _candidates.clear();
+    _candidates.reserve(cellCount);
+    _candidateSlot.assign(cellCount, -1);
+    _completed[0] = _completed[1] = 0;
+    _stones = 0;
+    _side = 1;
+    _score = 0;
+    _hash = 0;
+}
+
+void MNKPosition::setSideToMove(int player)
+{
+    if (player != _side) {
+        _hash ^= _zobrist.back();
+        _side = player;
+    }
+}
+
+void MNKPosition::load(const BoardSnapshot &snapshot)
+{
+    clear();
+    for (int cell = 0; cell < (int)_cells.size() && cell < snapshot.cells(); cell++) {
+        int player = snapshot.get(cell);
+        if (player) {
+            place(cell, player);
+        }
+    }
+    setSideToMove(snapshot.sideToMove() + 1);
+}
+
+int MNKPosition::windowScore(int window) const
+{
+    int first = _counts[window * 2];
+    int second = _counts[window * 2 + 1];
+    if (first && second) return 0;     // blocked, nobody can win here any more
+    if (first) return _weights[first];
+    if (second) return -_weights[second];
+    return 0;
+}
+
+void MNKPosition::place(int cell, int player)
+{
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        int w = _cellWindows[i];
+        _score -= windowScore(w);
+        if (++_counts[w * 2 + player - 1] == _winLength) {
+            _completed[player - 1]++;
+        }
+        _score += windowScore(w);
+    }
+    _cells[cell] = (uint8_t)player;
+    _hash ^= _zobrist[cell * 2 + player - 1];
+    _stones++;
+    removeCandidate(cell);
+    touchNeighbours(cell, 1);
+}
+
+void MNKPosition::remove(int cell)
+{
+    int player = _cells[cell];
+    if (!player) return;
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        int w = _cellWindows[i];
+        _score -= windowScore(w);
+        if (_counts[w * 2 + player - 1]-- == _winLength) {
+            _completed[player - 1]--;
+        }
+        _score += windowScore(w);
+    }
+    _cells[cell] = 0;
+    _hash ^= _zobrist[cell * 2 + player - 1];
+    _stones--;
+    touchNeighbours(cell, -1);
+    if (_near[cell] > 0) {
+        addCandidate(cell);
+    }
+}
+
+//
+// candidate bookkeeping, swap-remove keeps both operations O(1)
+//
+void MNKPosition::addCandidate(int cell)
+{
+    if (_candidateSlot[cell] >= 0) return;
+    _candidateSlot[cell] = (int)_candidates.size();
+    _candidates.push_back(cell);
+}
+
+void MNKPosition::removeCandidate(int cell)
+{
+    int slot = _candidateSlot[cell];
+    if (slot < 0) return;
+    int last = _candidates.back();
+    _candidates[slot] = last;
+    _candidateSlot[last] = slot;
+    _candidates.pop_back();
+    _candidateSlot[cell] = -1;
+}
+
+void MNKPosition::touchNeighbours(int cell, int delta)
+{
+    int cx = cell % _width;
+    int cy = cell / _width;
+    for (int y = std::max(0, cy - CANDIDATE_RADIUS); y <= std::min(_height - 1, cy + CANDIDATE_RADIUS); y++) {
+        for (int x = std::max(0, cx - CANDIDATE_RADIUS); x <= std::min(_width - 1, cx + CANDIDATE_RADIUS); x++) {
+            int n = y * _width + x;
+            if (n == cell) continue;
+            _near[n] += delta;
+            if (_cells[n]) continue;
+            if (_near[n] > 0) {
+                addCandidate(n);
+            } else {
+                removeCandidate(n);
+            }
+        }
+    }
+}
+
+//
+// threats
+//
+int MNKPosition::findWinningCell(int player) const
+{
+    const int own = player - 1;
+    for (int w = 0; w < (int)_windows.size(); w++) {
+        if (_counts[w * 2 + own] != _winLength - 1 || _counts[w * 2 + (1 - own)] != 0) continue;
+        for (int i = 0; i < _winLength; i++) {
+            int c = windowCell(w, i);
+            if (!_cells[c]) return c;
+        }
+    }
+    return -1;
+}
+
+int MNKPosition::winningCellsThrough(int cell, int player, int *cells, int maxCells) const
+{
+    const int own = player - 1;
+    int found = 0;
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1] && found < maxCells; i++) {
+        int w = _cellWindows[i];
+        if (_counts[w * 2 + own] != _winLength - 1 || _counts[w * 2 + (1 - own)] != 0) continue;
+        for (int j = 0; j < _winLength; j++) {
+            int c = windowCell(w, j);
+            if (_cells[c]) continue;
+            if (std::find(cells, cells + found, c) == cells + found) {
+                cells[found++] = c;
+            }
+            break;
+        }
+    }
+    return found;
+}
+
+bool MNKPosition::makesFour(int cell, int player) const
+{
+    const int own = player - 1;
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        int w = _cellWindows[i];
+        if (_counts[w * 2 + own] == _winLength - 2 && _counts[w * 2 + (1 - own)] == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// moves are ordered by how much they extend our lines plus how much they block the opponent's
+//
+int MNKPosition::moveOrderScore(int cell, int player) const
+{
+    const int own = player - 1;
+    int score = 0;
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        int w = _cellWindows[i];
+        int mine = _counts[w * 2 + own];
+        int theirs = _counts[w * 2 + (1 - own)];
+        if (theirs == 0) score += _weights[mine + 1];      // extends our line
+        if (mine == 0) score += _weights[theirs + 1] / 2;  // blocks theirs
+    }
+    return score;
+}
+
+int MNKPosition::orderedCandidates(int player, int *cells, int maxCells) const
+{
+    std::pair<int, int> scored[MAX_ORDERED];
+    int count = 0;
+    for (int c : _candidates) {
+        int s = moveOrderScore(c, player);
+        if (count < (int)(sizeof(scored) / sizeof(scored[0]))) {
+            scored[count++] = { s, c };
+        } else {
+            // keep the array bounded on huge boards, replacing the weakest entry
+            auto weakest = std::min_element(scored, scored + count);
+            if (weakest->first < s) *weakest = { s, c };
+        }
+    }
+    int keep = std::min(count, maxCells);
+    std::partial_sort(scored, scored + keep, scored + count, [](const auto &a, const auto &b) { return a.first > b.first; });
+    for (int i = 0; i < keep; i++) {
+        cells[i] = scored[i].second;
+    }
+    return keep;
+}
+
+void MNKPosition::generateMoves(MoveList<Move, MAX_MOVES> &list) const
+{
+    if (isFull()) return;
+    if (_stones == 0) {
+        list.add({ centerCell() });
+        return;
+    }
+    // a win ends the game and an unanswered threat loses it, neither needs alternatives
+    int cell = findWinningCell(_side);
+    if (cell < 0) {
+        cell = findWinningCell(3 - _side);
+    }
+    if (cell >= 0) {
+        list.add({ cell });
+        return;
+    }
+    int cells[MAX_MOVES];
+    int count = orderedCandidates(_side, cells, MAX_MOVES);
+    for (int i = 0; i < count; i++) {
+        list.add({ cells[i] });
+    }
+}
+
+void MNKPosition::generateAllMoves(std::vector<Move> &moves) const
+{
+    for (int cell = 0; cell < _width * _height; cell++) {
+        if (_cells[cell] == 0) {
+            moves.push_back({ cell });
+        }
+    }
+}
+
+bool MNKPosition::isTerminal(int &score) const
+{
+    if (hasWon(1) || hasWon(2)) {
+        // only the player who just moved can have completed a line
+        score = -SEARCH_WIN;
+        return true;
+    }
+    if (isFull()) {
+        score = 0;
+        return true;
+    }
+    return false;
+}
+
+// column letter and row number, a1 in the top left corner
+std::string MNKPosition::moveText(const Move &move) const
+{
+    return std::string(1, (char)('a' + move.cell % _width)) + std::to_string(move.cell / _width + 1);
+}
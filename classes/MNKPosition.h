@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Search.h"
+#include "BoardSnapshot.h"
+#include <vector>
+#include <cstdint>
+
+//
+// board for m,n,k games (tic-tac-toe, gomoku, connect-5 and friends)
+// it knows nothing about sprites or the gui, it only tracks stones in cells
+//
+// the board is described by every k-long line segment ("window") on it. each window
+// keeps a count of the stones each player has inside it, so placing or removing a stone
+// only touches the windows through that cell and the evaluation is updated incrementally
+//
+// players are 1 and 2, cells are indexed y * width + x
+//
+class MNKPosition
+{
+public:
+    struct Move
+    {
+        int     cell = -1;
+        bool    operator==(const Move &other) const = default;
+    };
+    // only the best few candidates are searched at each node
+    static const int MAX_MOVES = 12;
+
+    MNKPosition(int width, int height, int winLength);
+
+    // board setup
+    void        clear();
+    void        place(int cell, int player);
+    void        remove(int cell);
+    void        setSideToMove(int player);
+    // cells hold 0 or the player whose stone is there, the snapshot's side to move is a player number
+    void        load(const BoardSnapshot &snapshot);
+
+    // queries
+    int         width() const { return _width; }
+    int         height() const { return _height; }
+    int         winLength() const { return _winLength; }
+    int         sideToMove() const { return _side; }
+    int         stoneAt(int cell) const { return _cells[cell]; }
+    int         stoneCount() const { return _stones; }
+    bool        hasWon(int player) const { return _completed[player - 1] > 0; }
+    bool        isFull() const { return _stones == _width * _height; }
+    int         centerCell() const { return (_height / 2) * _width + _width / 2; }
+    const std::vector<int> &candidates() const { return _candidates; }
+
+    // evaluation from the point of view of player
+    int         evaluateFor(int player) const { return player == 1 ? _score : -_score; }
+
+    // threats
+    int         findWinningCell(int player) const;
+    int         winningCellsThrough(int cell, int player, int *cells, int maxCells) const;
+    bool        makesFour(int cell, int player) const;
+    int         orderedCandidates(int player, int *cells, int maxCells) const;
+
+    // SearchPosition
+    void        generateMoves(MoveList<Move, MAX_MOVES> &list) const;
+    // every empty cell, generateMoves keeps only the best few candidates
+    void        generateAllMoves(std::vector<Move> &moves) const;
+    void        makeMove(Move &move) { place(move.cell, _side); setSideToMove(3 - _side); }
+    void        unmakeMove(const Move &move) { remove(move.cell); setSideToMove(3 - _side); }
+    int         evaluate() const { return evaluateFor(_side); }
+    uint64_t    hash() const { return _hash; }
+    bool        isTerminal(int &score) const;
+    std::string moveText(const Move &move) const;
+
+private:
+    struct Window
+    {
+        int start;
+        int step;
+    };
+
+    // precomputed geometry
+    void        buildWindows();
+    int         windowCell(int window, int i) const { return _windows[window].start + _windows[window].step * i; }
+    int         windowScore(int window) const;
+    int         moveOrderScore(int cell, int player) const;
+
+    // candidate moves are empty cells near existing stones
+    void        addCandidate(int cell);
+    void        removeCandidate(int cell);
+    void        touchNeighbours(int cell, int delta);
+
+    int         _width;
+    int         _height;
+    int         _winLength;
+    int         _stones;
+    int         _side;
+    int         _score;                     // incremental evaluation from player 1's point of view
+    uint64_t    _hash;
+
+    std::vector<uint8_t>    _cells;
+    std::vector<Window>     _windows;
+    std::vector<uint8_t>    _counts;        // two counts per window
+    std::vector<int>        _cellWindows;   // windows through each cell, flattened
+    std::vector<int>        _cellWindowStart;
+    std::vector<int>        _weights;       // value of a window holding n stones of one player
+    std::vector<uint64_t>   _zobrist;       // two keys per cell plus one for the side to move
+    int                     _completed[2];  // windows filled by each player
+
+    std::vector<int>        _near;          // stones within the candidate radius of each cell
+    std::vector<int>        _candidates;
+    std::vector<int>        _candidateSlot;
+};
@@ -7,7 +7,7 @@ const int Othello::DIRECTIONS[8][2] = {
     {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
 };
 
-Othello::Othello() : Game() {
+Othello::Othello() : Game(), _aiThread(_searcher) {
     _grid = new Grid(8, 8);
     _consecutivePasses = 0;
     _showingHints = false;
@@ -51,6 +51,7 @@ Bit* Othello::createPiece(Player* player) {
     Bit* bit = new Bit();
     bit->LoadTextureFromFile(player == getPlayerAt(BLACK_PLAYER) ? "o.png" : "x.png");
     bit->setOwner(player);
+    bit->setGameTag(player == getPlayerAt(BLACK_PLAYER) ? 1 : 2);
     return bit;
 }
 
@@ -70,7 +71,10 @@ bool Othello::actionForEmptyHolder(BitHolder &holder) {
     holder.setBit(newPiece);
 
     // Flip all affected pieces
-    flipPieces(x, y, currentPlayer);
+    GameMove move = GameMove::drop(holderIndex(holder), newPiece->gameTag(), currentPlayer->playerNumber());
+    move.flips = flipPieces(x, y, currentPlayer);
+    move.captured = 3 - newPiece->gameTag();
+    recordMove(move);
     _consecutivePasses = 0;
 
     // Check if next player has moves
@@ -89,6 +93,17 @@ bool Othello::actionForEmptyHolder(BitHolder &holder) {
     return true;
 }
 
+void Othello::makeMove(const GameMove &move) {
+    Game::makeMove(move);
+    _consecutivePasses = move.isPass() ? _consecutivePasses + 1 : 0;
+}
+
+void Othello::unmakeMove(const GameMove &move) {
+    Game::unmakeMove(move);
+    // undo always lands on the start of a turn, the side to move there was not passing
+    _consecutivePasses = 0;
+}
+
 bool Othello::canBitMoveFrom(Bit &bit, BitHolder &src) {
     return false; // Pieces cannot be moved in Othello
 }
@@ -131,16 +146,19 @@ int Othello::checkDirection(int x, int y, int dx, int dy, Player* player) const
     return 0;
 }
 
-void Othello::flipPieces(int x, int y, Player* player) {
+uint64_t Othello::flipPieces(int x, int y, Player* player) {
+    uint64_t flipped = 0;
     for (int i = 0; i < 8; i++) {
         int count = checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player);
         if (count > 0) {
-            flipInDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player, count);
+            flipped |= flipInDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player, count);
         }
     }
+    return flipped;
 }
 
-void Othello::flipInDirection(int x, int y, int dx, int dy, Player* player, int count) {
+uint64_t Othello::flipInDirection(int x, int y, int dx, int dy, Player* player, int count) {
+    uint64_t flipped = 0;
     int nx = x + dx;
     int ny = y + dy;
 
@@ -151,10 +169,12 @@ void Othello::flipInDirection(int x, int y, int dx, int dy, Player* player, int
             Bit* newPiece = createPiece(player);
             newPiece->setPosition(square->getPosition());
             square->setBit(newPiece);
+            flipped |= 1ull << (ny * 8 + nx);
         }
         nx += dx;
         ny += dy;
     }
+    return flipped;
 }
 
 bool Othello::hasValidMove(Player* player) const {
@@ -243,6 +263,8 @@ void Othello::countPieces(int &blackCount, int &whiteCount) const {
 }
 
 void Othello::stopGame() {
+    stopAI();
+    clearValidMoveIndicators();
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
@@ -307,24 +329,16 @@ void Othello::updateAI() {
         return;
     }
 
-    // Find move that flips the most pieces
-    int bestX = -1, bestY = -1, maxFlips = 0;
-
-    for (const auto& move : validMoves) {
-        int x = move.first, y = move.second, totalFlips = 0;
-        for (int i = 0; i < 8; i++) {
-            totalFlips += checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], aiPlayer);
-        }
-        if (totalFlips > maxFlips) {
-            maxFlips = totalFlips;
-            bestX = x;
-            bestY = y;
+    OthelloPosition position;
+    position.load(snapshot());
+    // the search runs on its own thread, this is called every frame until its result is in
+    SearchResult<OthelloPosition::Move> result;
+    if (_aiThread.poll(position, aiSearchLimits(), result) && result.hasMove && result.bestMove.square != OthelloPosition::PASS) {
+        actionForEmptyHolder(*_grid->getSquare(result.bestMove.square % 8, result.bestMove.square / 8));
+        if (shouldPonder()) {
+            _aiThread.ponder(position, result, aiSearchLimits());
         }
     }
-
-    if (bestX >= 0 && bestY >= 0) {
-        actionForEmptyHolder(*_grid->getSquare(bestX, bestY));
-    }
 }
 
 void Othello::getBoardPosition(BitHolder& holder, int &x, int &y) const {
@@ -334,9 +348,34 @@ void Othello::getBoardPosition(BitHolder& holder, int &x, int &y) const {
 }
 
 void Othello::showValidMoves(Player* player) {
+    _hintPosition.load(snapshot());
+    _hintPosition.setSideToMove(player == getPlayerAt(BLACK_PLAYER) ? 1 : 2);
+    _hints.request(_hintPosition, hintSearchLimits());
     _showingHints = true;
 }
 
 void Othello::clearValidMoveIndicators() {
+    _hints.cancel();
     _showingHints = false;
+}
+
+//
+// every legal square is tinted by how its move scores against the others
+//
+void Othello::drawHints(BoardRenderer &renderer) {
+    if (getCurrentPlayer()->isAIPlayer()) {
+        if (_showingHints) clearValidMoveIndicators();
+        return;
+    }
+    showValidMoves(getCurrentPlayer());
+    const auto *hints = _hints.find(_hintPosition);
+    if (!hints) return;
+
+    int low, high;
+    hints->range(low, high);
+    for (const auto &hint : hints->moves) {
+        if (hint.move.square != OthelloPosition::PASS) {
+            drawHint(renderer, *_grid->getSquare(hint.move.square % 8, hint.move.square / 8), hint.score, low, high);
+        }
+    }
 }
\ No newline at end of file
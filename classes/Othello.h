@@ -1,5 +1,8 @@
 #pragma once
 #include "Game.h"
+#include "OthelloPosition.h"
+#include "SearchThread.h"
+#include "HintThread.h"
 #include <vector>
 
 // NOTE: This implementation assumes black.png and white.png exist in resources.
@@ -13,6 +16,7 @@ public:
 
     // Required virtual methods from Game base class
     void        setUpBoard() override;
+    const char *gameName() const override { return "Othello"; }
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
     std::string initialStateString() override;
@@ -23,11 +27,24 @@ public:
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
     void        stopGame() override;
 
+    // undo / redo
+    void        makeMove(const GameMove &move) override;
+    void        unmakeMove(const GameMove &move) override;
+    Bit*        pieceForTag(int tag) override { return createPiece(getPlayerAt(tag == 1 ? BLACK_PLAYER : WHITE_PLAYER)); }
+
     // AI methods
     void        updateAI() override;
+    void        stopAI() override { _aiThread.cancel(); }
+    bool        searchStats(SearchStats &stats) const override { stats = _aiThread.stats(); return true; }
     bool        gameHasAI() override { return true; } // Set to true when AI is implemented
+    bool        hasHints() override { return true; }
+    bool        hintsRunning() const override { return _hints.running(); }
+    void        stopHints() override { clearValidMoveIndicators(); }
     Grid* getGrid() override { return _grid; }
 
+protected:
+    void        drawHints(BoardRenderer &renderer) override;
+
 private:
     // Player constants
     static const int BLACK_PLAYER = 0;
@@ -40,11 +57,13 @@ private:
     Bit*        createPiece(Player* player);
     bool        isValidMove(int x, int y, Player* player) const;
     int         checkDirection(int x, int y, int dx, int dy, Player* player) const;
-    void        flipPieces(int x, int y, Player* player);
-    void        flipInDirection(int x, int y, int dx, int dy, Player* player, int count);
+    // both return the squares turned over, one bit per square
+    uint64_t    flipPieces(int x, int y, Player* player);
+    uint64_t    flipInDirection(int x, int y, int dx, int dy, Player* player, int count);
     bool        hasValidMove(Player* player) const;
     void        countPieces(int &blackCount, int &whiteCount) const;
     std::vector<std::pair<int, int>> getValidMoves(Player* player) const;
+    // start scoring player's moves on the board for the hint overlay
     void        showValidMoves(Player* player);
     void        clearValidMoveIndicators();
 
@@ -53,6 +72,10 @@ private:
 
     // Board representation
     Grid*       _grid;
+    Searcher<OthelloPosition> _searcher;
+    SearchThread<Searcher<OthelloPosition>, OthelloPosition> _aiThread;
+    HintThread<OthelloPosition> _hints;
+    OthelloPosition _hintPosition;      // the position showValidMoves asked about
 
     // Game state
     int         _consecutivePasses;
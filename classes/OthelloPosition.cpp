@@ -0,0 +1,172 @@
+#include "OthelloPosition.h"
+#include <algorithm>
+#include <bit>
+
+static const uint64_t NOT_FILE_A = 0xFEFEFEFEFEFEFEFEull;
+static const uint64_t NOT_FILE_H = 0x7F7F7F7F7F7F7F7Full;
+
+// shift amounts and the wrap-around masks for the 8 directions
+static const int SHIFTS[8] = { 1, -1, 8, -8, 9, -9, 7, -7 };
+static const uint64_t SHIFT_MASKS[8] = { NOT_FILE_A, NOT_FILE_H, ~0ull, ~0ull, NOT_FILE_A, NOT_FILE_H, NOT_FILE_H, NOT_FILE_A };
+
+// classic static square weights, corners good and the squares next to them bad
+static const int SQUARE_WEIGHTS[64] = {
+    100, -20,  10,   5,   5,  10, -20, 100,
+    -20, -50,  -2,  -2,  -2,  -2, -50, -20,
+     10,  -2,   1,   1,   1,   1,  -2,  10,
+      5,  -2,   1,   0,   0,   1,  -2,   5,
+      5,  -2,   1,   0,   0,   1,  -2,   5,
+     10,  -2,   1,   1,   1,   1,  -2,  10,
+    -20, -50,  -2,  -2,  -2,  -2, -50, -20,
+    100, -20,  10,   5,   5,  10, -20, 100,
+};
+
+static inline uint64_t shift(uint64_t bits, int dir)
+{
+    int s = SHIFTS[dir];
+    return (s > 0 ? bits << s : bits >> -s) & SHIFT_MASKS[dir];
+}
+
+OthelloPosition::OthelloPosition()
+{
+    clear();
+}
+
+void OthelloPosition::clear()
+{
+    _discs[0] = _discs[1] = 0;
+    _side = 1;
+}
+
+void OthelloPosition::setStone(int x, int y, int player)
+{
+    _discs[player - 1] |= 1ull << (y * 8 + x);
+}
+
+void OthelloPosition::load(const BoardSnapshot &snapshot)
+{
+    clear();
+    for (int cell = 0; cell < 64 && cell < snapshot.cells(); cell++) {
+        int player = snapshot.get(cell);
+        if (player) {
+            setStone(cell % 8, cell / 8, player);
+        }
+    }
+    setSideToMove(snapshot.sideToMove() + 1);
+}
+
+uint64_t OthelloPosition::legalMovesFor(uint64_t own, uint64_t opp)
+{
+    const uint64_t empty = ~(own | opp);
+    uint64_t moves = 0;
+    for (int dir = 0; dir < 8; dir++) {
+        // walk runs of opponent discs that start next to one of ours
+        uint64_t run = shift(own, dir) & opp;
+        for (int i = 0; i < 5; i++) {
+            run |= shift(run, dir) & opp;
+        }
+        moves |= shift(run, dir) & empty;
+    }
+    return moves;
+}
+
+uint64_t OthelloPosition::flipsFor(int square) const
+{
+    const uint64_t own = _discs[_side - 1];
+    const uint64_t opp = _discs[2 - _side];
+    const uint64_t start = 1ull << square;
+    uint64_t flips = 0;
+    for (int dir = 0; dir < 8; dir++) {
+        uint64_t line = 0;
+        uint64_t bit = shift(start, dir);
+        while (bit & opp) {
+            line |= bit;
+            bit = shift(bit, dir);
+        }
+        if (bit & own) {
+            flips |= line;
+        }
+    }
+    return flips;
+}
+
+void OthelloPosition::generateMoves(MoveList<Move, MAX_MOVES> &list) const
+{
+    uint64_t moves = legalMoves();
+    if (!moves) {
+        // a side with no move has to pass, unless the game is over
+        if (legalMovesFor(_discs[2 - _side], _discs[_side - 1])) {
+            list.add({ PASS, 0 });
+        }
+        return;
+    }
+    while (moves) {
+        int square = std::countr_zero(moves);
+        moves &= moves - 1;
+        list.add({ square, 0 });
+    }
+    std::stable_sort(list.begin(), list.end(), [](const Move &a, const Move &b) {
+        return SQUARE_WEIGHTS[a.square] > SQUARE_WEIGHTS[b.square];
+    });
+}
+
+void OthelloPosition::generateAllMoves(std::vector<Move> &moves) const
+{
+    MoveList<Move, MAX_MOVES> list;
+    generateMoves(list);
+    moves.assign(list.begin(), list.end());
+}
+
+void OthelloPosition::makeMove(Move &move)
+{
+    if (move.square != PASS) {
+        move.flips = flipsFor(move.square);
+        _discs[_side - 1] |= move.flips | (1ull << move.square);
+        _discs[2 - _side] &= ~move.flips;
+    }
+    _side = 3 - _side;
+}
+
+void OthelloPosition::unmakeMove(const Move &move)
+{
+    _side = 3 - _side;
+    if (move.square != PASS) {
+        _discs[_side - 1] &= ~(move.flips | (1ull << move.square));
+        _discs[2 - _side] |= move.flips;
+    }
+}
+
+//
+// square weights plus mobility, both from the side to move's point of view
+//
+int OthelloPosition::evaluate() const
+{
+    const uint64_t own = _discs[_side - 1];
+    const uint64_t opp = _discs[2 - _side];
+    int score = 0;
+    for (uint64_t bits = own; bits; bits &= bits - 1) score += SQUARE_WEIGHTS[std::countr_zero(bits)];
+    for (uint64_t bits = opp; bits; bits &= bits - 1) score -= SQUARE_WEIGHTS[std::countr_zero(bits)];
+    score += 5 * (std::popcount(legalMovesFor(own, opp)) - std::popcount(legalMovesFor(opp, own)));
+    return score;
+}
+
+bool OthelloPosition::isTerminal(int &score) const
+{
+    const uint64_t own = _discs[_side - 1];
+    const uint64_t opp = _discs[2 - _side];
+    if (legalMovesFor(own, opp) || legalMovesFor(opp, own)) {
+        return false;
+    }
+    int diff = std::popcount(own) - std::popcount(opp);
+    score = diff > 0 ? SEARCH_WIN : diff < 0 ? -SEARCH_WIN : 0;
+    return true;
+}
+
+// the usual othello names, a1 in the top left corner
+std::string OthelloPosition::moveText(const Move &move) const
+{
+    if (move.square == PASS) {
+        return "pass";
+    }
+    return std::string(1, (char)('a' + (move.square & 7))) + std::to_string((move.square >> 3) + 1);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Search.h"
+#include "BoardSnapshot.h"
+#include <cstdint>
+#include <vector>
+
+//
+// othello as a pair of bitboards for the search
+// bit y * 8 + x is the square at column x, row y. players are 1 (black) and 2 (white)
+//
+class OthelloPosition
+{
+public:
+    static const int PASS = 64;
+
+    struct Move
+    {
+        int         square = -1;
+        uint64_t    flips = 0;      // filled in by makeMove so unmakeMove can put them back
+
+        bool operator==(const Move &other) const { return square == other.square; }
+    };
+    static const int MAX_MOVES = 40;
+
+    OthelloPosition();
+
+    void        clear();
+    void        setStone(int x, int y, int player);
+    // cells hold 0, 1 (black) or 2 (white), the snapshot's side to move is a player number
+    void        load(const BoardSnapshot &snapshot);
+    void        setSideToMove(int player) { _side = player; }
+    int         sideToMove() const { return _side; }
+
+    // every legal square for the side to move as a bitboard
+    uint64_t    legalMoves() const { return legalMovesFor(_discs[_side - 1], _discs[2 - _side]); }
+    // discs that would turn over if the side to move played square
+    uint64_t    flipsFor(int square) const;
+
+    // SearchPosition
+    void        generateMoves(MoveList<Move, MAX_MOVES> &list) const;
+    // the same moves as generateMoves, othello has none to leave out
+    void        generateAllMoves(std::vector<Move> &moves) const;
+    void        makeMove(Move &move);
+    void        unmakeMove(const Move &move);
+    int         evaluate() const;
+    uint64_t    hash() const { return mixHash(_discs[_side - 1]) ^ mixHash(~_discs[2 - _side]); }
+    bool        isTerminal(int &score) const;
+    std::string moveText(const Move &move) const;
+
+private:
+    static uint64_t legalMovesFor(uint64_t own, uint64_t opp);
+
+    uint64_t    _discs[2];
+    int         _side;
+};
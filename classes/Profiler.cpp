@@ -0,0 +1,136 @@
+#include "Profiler.h"
+
+#ifdef PROFILER_ENABLED
+
+#include "../imgui/imgui.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+// frames over this are drawn off the top of the graph
+static const float GRAPH_MAX_MS = 33.3f;
+
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() : _scopeCount(0), _frame(0), _frames(0), _frameStart(std::chrono::steady_clock::now())
+{
+    std::memset(_frameMs, 0, sizeof(_frameMs));
+}
+
+int Profiler::scopeId(const char *name)
+{
+    for (int i = 0; i < _scopeCount; i++) {
+        if (std::strcmp(_scopes[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (_scopeCount == MAX_SCOPES) {
+        // everything past the limit is lumped in with the last scope
+        return MAX_SCOPES - 1;
+    }
+    Scope &scope = _scopes[_scopeCount];
+    scope.name = name;
+    std::memset(scope.ms, 0, sizeof(scope.ms));
+    std::memset(scope.calls, 0, sizeof(scope.calls));
+    scope.frameNanoseconds = 0;
+    scope.frameCalls = 0;
+    return _scopeCount++;
+}
+
+void Profiler::record(int scope, int64_t nanoseconds)
+{
+    _scopes[scope].frameNanoseconds += nanoseconds;
+    _scopes[scope].frameCalls++;
+}
+
+void Profiler::endFrame()
+{
+    auto now = std::chrono::steady_clock::now();
+    _frameMs[_frame] = std::chrono::duration<float, std::milli>(now - _frameStart).count();
+    _frameStart = now;
+
+    for (int i = 0; i < _scopeCount; i++) {
+        Scope &scope = _scopes[i];
+        scope.ms[_frame] = scope.frameNanoseconds / 1.0e6f;
+        scope.calls[_frame] = scope.frameCalls;
+        scope.frameNanoseconds = 0;
+        scope.frameCalls = 0;
+    }
+    _frame = (_frame + 1) % HISTORY;
+    _frames = std::min(_frames + 1, HISTORY);
+}
+
+void Profiler::percentiles(const float *history, float result[3]) const
+{
+    float sorted[HISTORY];
+    std::copy(history, history + _frames, sorted);
+    static const float RANKS[3] = { 0.50f, 0.95f, 0.99f };
+    for (int i = 0; i < 3; i++) {
+        float *nth = sorted + std::min((int)(RANKS[i] * _frames), _frames - 1);
+        std::nth_element(sorted, nth, sorted + _frames);
+        result[i] = *nth;
+    }
+}
+
+void Profiler::drawWindow(bool *open)
+{
+    if (!ImGui::Begin("Profiler", open) || _frames == 0) {
+        ImGui::End();
+        return;
+    }
+
+    // the oldest frame is at _frame once the buffer has wrapped
+    int oldest = _frames == HISTORY ? _frame : 0;
+    int last = (_frame + HISTORY - 1) % HISTORY;
+    float frame[3];
+    percentiles(_frameMs, frame);
+    ImGui::Text("Frame %.2f ms   p50 %.2f   p95 %.2f   p99 %.2f", _frameMs[last], frame[0], frame[1], frame[2]);
+    ImGui::PlotLines("##frames", _frameMs, _frames, oldest, nullptr, 0.0f, GRAPH_MAX_MS, ImVec2(-1, 80));
+
+    if (ImGui::BeginTable("scopes", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Last ms");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < _scopeCount; i++) {
+            const Scope &scope = _scopes[i];
+            float result[3];
+            percentiles(scope.ms, result);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(scope.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", scope.calls[last]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.ms[last]);
+            for (int p = 0; p < 3; p++) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", result[p]);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    // one graph per scope, folded away until wanted
+    if (ImGui::CollapsingHeader("Scope graphs")) {
+        for (int i = 0; i < _scopeCount; i++) {
+            ImGui::PlotLines(_scopes[i].name, _scopes[i].ms, _frames, oldest, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+        }
+    }
+#ifdef ALLOC_TRACKER_ENABLED
+    if (ImGui::CollapsingHeader("Allocations", ImGuiTreeNodeFlags_DefaultOpen)) {
+        AllocTracker::drawStats();
+    }
+#endif
+    ImGui::End();
+}
+
+#endif
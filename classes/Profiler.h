@@ -0,0 +1,81 @@
+#pragma once
+
+//
+// scoped timers and a window showing where the frame time goes
+//
+// PROFILE_SCOPE("name") times the rest of the enclosing block. every scope adds its time to the
+// current frame, and endFrame() moves the frame into a ring buffer of the last HISTORY frames
+// that the window takes its graphs and percentiles from. timers are for the render thread only
+//
+// it is built with PROFILER_ENABLED (cmake -DENABLE_PROFILER=ON). without it PROFILE_SCOPE is
+// empty and none of this is compiled
+//
+#ifdef PROFILER_ENABLED
+
+#include <chrono>
+#include <cstdint>
+
+class Profiler
+{
+public:
+    static const int MAX_SCOPES = 32;
+    static const int HISTORY = 240;
+
+    static Profiler &instance();
+
+    // an id for a scope name, PROFILE_SCOPE looks it up once per call site
+    int         scopeId(const char *name);
+    void        record(int scope, int64_t nanoseconds);
+    // close the frame, call once a frame before any scope of the next one
+    void        endFrame();
+    void        drawWindow(bool *open);
+
+private:
+    Profiler();
+
+    struct Scope
+    {
+        const char  *name;
+        float       ms[HISTORY];        // time per frame
+        int         calls[HISTORY];
+        int64_t     frameNanoseconds;   // the frame being recorded
+        int         frameCalls;
+    };
+
+    // p50, p95 and p99 of the frames in the history
+    void        percentiles(const float *history, float result[3]) const;
+
+    Scope       _scopes[MAX_SCOPES];
+    int         _scopeCount;
+    float       _frameMs[HISTORY];
+    int         _frame;                 // next slot in the ring buffers
+    int         _frames;                // slots filled, up to HISTORY
+    std::chrono::steady_clock::time_point _frameStart;
+};
+
+class ProfileTimer
+{
+public:
+    explicit ProfileTimer(int scope) : _scope(scope), _start(std::chrono::steady_clock::now()) {}
+    ~ProfileTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - _start;
+        Profiler::instance().record(_scope, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+private:
+    int         _scope;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_JOIN(profileScope, __LINE__) = Profiler::instance().scopeId(name); \
+    ProfileTimer PROFILE_JOIN(profileTimer, __LINE__)(PROFILE_JOIN(profileScope, __LINE__))
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+#endif
@@ -0,0 +1,37 @@
+#include "RenderQueue.h"
+#include "Sprite.h"
+#include <algorithm>
+
+void RenderQueue::add(Sprite *sprite)
+{
+    // the bitz layers all fit in 16 bits, anything outside is pinned to the nearest end
+    int z = std::clamp(sprite->getLocalZOrder(), 0, 0xffff);
+    _items.push_back(Item{ sprite, (uint16_t)z });
+}
+
+void RenderQueue::paint(BoardRenderer &renderer)
+{
+    // least significant byte first, each pass is a counting sort so equal keys keep their order
+    _sorted.resize(_items.size());
+    for (int shift = 0; shift < 16; shift += 8) {
+        size_t offsets[257] = {};
+        for (const Item &item : _items) {
+            offsets[((item.z >> shift) & 0xff) + 1]++;
+        }
+        if (offsets[(_items.empty() ? 0 : ((_items[0].z >> shift) & 0xff)) + 1] == _items.size()) {
+            // every key has the same byte, this pass would not move anything
+            continue;
+        }
+        for (int i = 1; i < 257; i++) {
+            offsets[i] += offsets[i - 1];
+        }
+        for (const Item &item : _items) {
+            _sorted[offsets[(item.z >> shift) & 0xff]++] = item;
+        }
+        _items.swap(_sorted);
+    }
+
+    for (const Item &item : _items) {
+        item.sprite->paintSprite(renderer);
+    }
+}
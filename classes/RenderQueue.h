@@ -0,0 +1,33 @@
+#pragma once
+#include "BoardRenderer.h"
+#include <cstdint>
+#include <vector>
+
+class Sprite;
+
+//
+// the sprites of one frame in the order they should be painted
+//
+// the board is walked once and every square and bit goes in with its local z order, see bitz
+// in Bit.h. paint() sorts them with a stable two pass radix sort on the z order, so sprites on
+// the same layer keep the order they were added in and a piece in the air is drawn over
+// everything on the board whatever square it came from
+//
+class RenderQueue
+{
+public:
+    void    clear() { _items.clear(); }
+    void    add(Sprite *sprite);
+    // sort by z order and queue everything on the renderer
+    void    paint(BoardRenderer &renderer);
+
+private:
+    struct Item
+    {
+        Sprite      *sprite;
+        uint16_t    z;
+    };
+
+    std::vector<Item>   _items;
+    std::vector<Item>   _sorted;    // radix sort scratch, kept so nothing is allocated per frame
+};
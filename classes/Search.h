@@ -0,0 +1,672 @@
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include "Trace.h"
+
+//
+// game agnostic search
+//
+// every game supplies a small position type that satisfies SearchPosition below and gets
+// alpha-beta, principal variation search, iterative deepening, a transposition table and
+// time control from the one implementation. everything is resolved at compile time through
+// the template parameter so there is no virtual call anywhere inside the search
+//
+// scores are always from the point of view of the side to move. a side that has lost
+// scores -SEARCH_WIN, the search folds the distance to the end of the game into that
+// so quicker wins are preferred
+//
+
+static const int SEARCH_WIN = 1000000000;
+static const int SEARCH_INFINITY = SEARCH_WIN + 1;
+static const int SEARCH_MAX_PLY = 128;
+static const int SEARCH_MAX_PV = 32;
+
+//
+// splitmix64 finalizer, turns packed boards into well spread hash keys
+//
+inline uint64_t mixHash(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+//
+// fixed capacity move list, lives on the stack of each search node
+//
+template <typename M, int N>
+struct MoveList
+{
+    M       moves[N];
+    int     count = 0;
+
+    void    add(const M &move) { if (count < N) moves[count++] = move; }
+    void    clear() { count = 0; }
+    bool    empty() const { return count == 0; }
+    M       *begin() { return moves; }
+    M       *end() { return moves + count; }
+    M       &operator[](int i) { return moves[i]; }
+    const M &operator[](int i) const { return moves[i]; }
+};
+
+//
+// what a position has to provide
+//
+//   using Move = ...;                      // small, trivially copyable, ==
+//   static const int MAX_MOVES = ...;      // most moves generateMoves can produce
+//   void generateMoves(MoveList<Move, MAX_MOVES> &list) const;   // best guesses first
+//   void makeMove(Move &move);             // may stash undo information in the move
+//   void unmakeMove(const Move &move);
+//   int  evaluate() const;                 // side to move, well inside +/-SEARCH_WIN
+//   uint64_t hash() const;
+//   bool isTerminal(int &score) const;     // game over? score is 0 or +/-SEARCH_WIN
+//
+// and optionally, for showing principal variations
+//
+//   std::string moveText(const Move &move) const;
+//
+template <typename P>
+concept SearchPosition = requires(P &position, const P &constPosition, typename P::Move &move,
+                                  MoveList<typename P::Move, P::MAX_MOVES> &list, int &score) {
+    { constPosition.generateMoves(list) };
+    { position.makeMove(move) };
+    { position.unmakeMove(move) };
+    { constPosition.evaluate() } -> std::convertible_to<int>;
+    { constPosition.hash() } -> std::convertible_to<uint64_t>;
+    { constPosition.isTerminal(score) } -> std::convertible_to<bool>;
+} && std::is_trivially_copyable_v<typename P::Move> && std::equality_comparable<typename P::Move>;
+
+struct SearchLimits
+{
+    int     maxDepth = 64;
+    int     timeMs = 1000;
+    int     sliceUs = 0;    // for SearchThread: search this long per poll() on the caller's thread, 0 for a worker thread
+};
+
+template <typename M>
+struct SearchResult
+{
+    M           bestMove{};
+    bool        hasMove = false;
+    int         score = 0;
+    int         depth = 0;
+    uint64_t    nodes = 0;
+    MoveList<M, SEARCH_MAX_PV> pv;      // bestMove first, then the expected replies
+};
+
+//
+// how a search is going, for the engine window. the search publishes a new copy after every
+// iteration and keeps the node count current in between, so another thread can read it at any
+// time through Searcher::stats()
+//
+struct SearchStats
+{
+    bool        searching = false;
+    bool        pondering = false;  // searching the reply the opponent is expected to play
+    int         depth = 0;          // deepest completed iteration
+    int         score = 0;
+    uint64_t    nodes = 0;
+    uint64_t    nodesPerSecond = 0;
+    uint64_t    ttHits = 0;
+    uint64_t    cutoffs = 0;
+    double      elapsedMs = 0;
+    std::string pv;
+};
+
+template <typename P>
+std::string searchMoveText(const P &position, const typename P::Move &move)
+{
+    if constexpr (requires { { position.moveText(move) } -> std::convertible_to<std::string>; }) {
+        return position.moveText(move);
+    } else {
+        return "?";
+    }
+}
+
+//
+// fixed size, always-replace-unless-shallower hash table
+//
+template <typename M>
+class TranspositionTable
+{
+public:
+    enum Bound : uint8_t { BoundNone, BoundExact, BoundLower, BoundUpper };
+
+    struct Entry
+    {
+        uint64_t    key = 0;
+        M           move{};
+        int         score = 0;
+        int16_t     depth = -1;
+        Bound       bound = BoundNone;
+    };
+
+    explicit TranspositionTable(size_t entries)
+    {
+        size_t size = 1;
+        while (size < entries) size <<= 1;
+        _entries.resize(size);
+        _mask = size - 1;
+    }
+
+    void clear() { std::fill(_entries.begin(), _entries.end(), Entry()); }
+
+    const Entry *probe(uint64_t key) const
+    {
+        const Entry &entry = _entries[key & _mask];
+        return (entry.bound != BoundNone && entry.key == key) ? &entry : nullptr;
+    }
+
+    void store(uint64_t key, const M &move, int score, int depth, Bound bound)
+    {
+        Entry &entry = _entries[key & _mask];
+        if (entry.key == key && entry.depth > depth) return;
+        entry.key = key;
+        entry.move = move;
+        entry.score = score;
+        entry.depth = (int16_t)depth;
+        entry.bound = bound;
+    }
+
+private:
+    std::vector<Entry>  _entries;
+    size_t              _mask;
+};
+
+template <SearchPosition P>
+class Searcher
+{
+public:
+    using Move = typename P::Move;
+    using Result = SearchResult<Move>;
+    using Table = TranspositionTable<Move>;
+
+    explicit Searcher(size_t tableEntries = 1 << 18)
+        : _table(tableEntries), _frames(SEARCH_MAX_PLY), _stop(false), _deadline(0), _pendingDeadline(0), _liveNodes(0) {}
+
+    //
+    // iterative deepening driver, returns the best move of the deepest completed iteration
+    //
+    Result search(P &position, const SearchLimits &limits)
+    {
+        begin(position, limits);
+        while (!step()) {
+        }
+        return _result;
+    }
+
+    //
+    // the same search a slice at a time, for callers with no thread to spare. begin() sets it
+    // up and each step() walks the tree for about sliceUs microseconds, 0 meaning until it is
+    // done, and returns true once result() is final. the search plays its moves on position in
+    // between, so it has to stay where it is, untouched, until then. the time limit is wall
+    // clock time from begin(), however the slices are spread out
+    //
+    void begin(P &position, const SearchLimits &limits)
+    {
+        _position = &position;
+        _limits = limits;
+        _result = Result();
+        _finished = false;
+        _aborted = false;
+        _resuming = false;
+        _nodes = 0;
+        _ttHits = 0;
+        _cutoffs = 0;
+        _liveNodes.store(0, std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        _deadline.store((start + std::chrono::milliseconds(limits.timeMs)).time_since_epoch().count());
+        // a setTimeLimit() that came in before this point has to win over limits.timeMs
+        if (auto pending = _pendingDeadline.load()) {
+            _deadline.store(pending);
+        }
+        {
+            std::lock_guard<std::mutex> lock(_statsMutex);
+            _stats = SearchStats();
+            _stats.searching = true;
+            _start = start;
+        }
+        std::fill(&_killers[0][0], &_killers[0][0] + SEARCH_MAX_PLY * 2, Move{});
+
+        // fall back on the first legal move if not even depth one finishes
+        MoveList<Move, P::MAX_MOVES> moves;
+        position.generateMoves(moves);
+        if (moves.empty()) {
+            finish();
+            return;
+        }
+        _result.bestMove = moves[0];
+        _result.hasMove = true;
+        _result.pv.add(moves[0]);
+
+        _depth = 0;
+        if (limits.maxDepth < 1) {
+            finish();
+            return;
+        }
+        startIteration();
+    }
+
+    bool step(int sliceUs = 0)
+    {
+        if (_finished) {
+            return true;
+        }
+        TRACE_SCOPE("search");
+        _sliceEnd = sliceUs > 0 ? (std::chrono::steady_clock::now() + std::chrono::microseconds(sliceUs)).time_since_epoch().count() : 0;
+        // a stop or the deadline may have come while the search was waiting for this slice
+        timeUp();
+        while (!_finished) {
+            int score;
+            if (!run(score)) {
+                if (!_aborted) {
+                    return false;
+                }
+                traceIteration();
+                finish();
+                break;
+            }
+            finishIteration(score);
+        }
+        return true;
+    }
+
+    const Result &result() const { return _result; }
+
+    // ask a running search to return as soon as possible, safe from another thread. the request
+    // holds until clearStop(), so it is not lost when it comes before the search gets going
+    void stop() { _stop.store(true, std::memory_order_relaxed); }
+    void clearStop() { _stop.store(false, std::memory_order_relaxed); _pendingDeadline.store(0); }
+
+    // give the running search timeMs more from now, whatever it was started with. safe from
+    // another thread, and if the search has not started yet it takes this over its own limit
+    void setTimeLimit(int timeMs)
+    {
+        auto deadline = (std::chrono::steady_clock::now() + std::chrono::milliseconds(timeMs)).time_since_epoch().count();
+        _pendingDeadline.store(deadline);
+        _deadline.store(deadline);
+    }
+
+    // the progress of the running search, or how the last one ended. safe from another thread
+    SearchStats stats() const
+    {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        SearchStats stats = _stats;
+        if (stats.searching) {
+            stats.nodes = _liveNodes.load(std::memory_order_relaxed);
+            stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+        }
+        stats.nodesPerSecond = stats.elapsedMs > 0 ? (uint64_t)(stats.nodes * 1000.0 / stats.elapsedMs) : 0;
+        return stats;
+    }
+
+    Table &table() { return _table; }
+
+private:
+    //
+    // one node of the tree being walked. what the recursive search would keep on the call
+    // stack lives here instead, so the walk can stop anywhere and pick up again later
+    //
+    enum class Stage : uint8_t { First, NullWindow, ReSearch };
+
+    struct Frame
+    {
+        MoveList<Move, P::MAX_MOVES> moves;
+        Move        move{};         // being searched, made on the board while a child is open
+        Move        bestMove{};
+        uint64_t    key = 0;
+        int         depth = 0;
+        int         alpha = 0;
+        int         beta = 0;
+        int         originalAlpha = 0;
+        int         best = 0;
+        int         index = 0;
+        Stage       stage = Stage::First;
+    };
+
+    bool timeUp()
+    {
+        _liveNodes.store(_nodes, std::memory_order_relaxed);
+        if (_stop.load(std::memory_order_relaxed) ||
+            std::chrono::steady_clock::now().time_since_epoch().count() >= _deadline.load(std::memory_order_relaxed)) {
+            _aborted = true;
+        }
+        return _aborted;
+    }
+
+    bool sliceOver() const
+    {
+        return _sliceEnd != 0 && std::chrono::steady_clock::now().time_since_epoch().count() >= _sliceEnd;
+    }
+
+    void startIteration()
+    {
+        _depth++;
+        _rootMoveFound = false;
+        _iterationStart = Tracer::enabled() ? Tracer::now() : 0;
+        _ply = 0;
+        _returning = false;
+        Frame &root = _frames[0];
+        root.depth = _depth;
+        root.alpha = -SEARCH_INFINITY;
+        root.beta = SEARCH_INFINITY;
+    }
+
+    void finishIteration(int score)
+    {
+        traceIteration();
+        if (_rootMoveFound) _result.bestMove = _rootMove;
+        _result.score = score;
+        _result.depth = _depth;
+        collectPV(*_position, _result);
+        publishStats(*_position, _result, true);
+        // a proven result will not change with more depth
+        bool proven = score >= SEARCH_WIN - SEARCH_MAX_PLY || score <= -SEARCH_WIN + SEARCH_MAX_PLY;
+        if (proven || _depth >= _limits.maxDepth || _depth + 1 >= SEARCH_MAX_PLY || timeUp()) {
+            finish();
+        } else {
+            startIteration();
+        }
+    }
+
+    void traceIteration()
+    {
+        if (_iterationStart) {
+            Tracer::record("search iteration", _iterationStart, Tracer::now(), "depth", _depth);
+            _iterationStart = 0;
+        }
+    }
+
+    void finish()
+    {
+        _result.nodes = _nodes;
+        _finished = true;
+        finishStats(*_position, _result);
+    }
+
+    // follow the hash moves from the root for as long as they are legal
+    void collectPV(P &position, Result &result)
+    {
+        result.pv.clear();
+        int terminalScore;
+        while (result.pv.count < SEARCH_MAX_PV && !position.isTerminal(terminalScore)) {
+            const auto *entry = _table.probe(position.hash());
+            if (!entry) break;
+            MoveList<Move, P::MAX_MOVES> moves;
+            position.generateMoves(moves);
+            Move *found = std::find(moves.begin(), moves.end(), entry->move);
+            if (found == moves.end()) break;
+            Move move = *found;
+            position.makeMove(move);
+            result.pv.add(move);
+        }
+        for (int i = result.pv.count - 1; i >= 0; i--) {
+            position.unmakeMove(result.pv[i]);
+        }
+        // the root entry can be overwritten deeper in the tree, the best move is still known
+        if (result.pv.empty() || !(result.pv[0] == result.bestMove)) {
+            result.pv.clear();
+            result.pv.add(result.bestMove);
+        }
+    }
+
+    void publishStats(const P &position, Result &result, bool searching)
+    {
+        std::string pv;
+        for (const Move &move : result.pv) {
+            if (!pv.empty()) pv += ' ';
+            pv += searchMoveText(position, move);
+        }
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _stats.searching = searching;
+        _stats.depth = result.depth;
+        _stats.score = result.score;
+        _stats.nodes = _nodes;
+        _stats.ttHits = _ttHits;
+        _stats.cutoffs = _cutoffs;
+        _stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+        _stats.pv.swap(pv);
+    }
+
+    void finishStats(const P &position, Result &result)
+    {
+        _liveNodes.store(_nodes, std::memory_order_relaxed);
+        publishStats(position, result, false);
+    }
+
+    // store mate scores relative to the node so they stay valid at any depth
+    static int toTable(int score, int ply)
+    {
+        if (score >= SEARCH_WIN - SEARCH_MAX_PLY) return score + ply;
+        if (score <= -SEARCH_WIN + SEARCH_MAX_PLY) return score - ply;
+        return score;
+    }
+
+    static int fromTable(int score, int ply)
+    {
+        if (score >= SEARCH_WIN - SEARCH_MAX_PLY) return score - ply;
+        if (score <= -SEARCH_WIN + SEARCH_MAX_PLY) return score + ply;
+        return score;
+    }
+
+    // move the hash move and the killers to the front, keeping the position's own order otherwise
+    void orderMoves(MoveList<Move, P::MAX_MOVES> &moves, const Move *hashMove, int ply)
+    {
+        int front = 0;
+        auto promote = [&](const Move &wanted) {
+            for (int i = front; i < moves.count; i++) {
+                if (moves[i] == wanted) {
+                    std::rotate(moves.begin() + front, moves.begin() + i, moves.begin() + i + 1);
+                    front++;
+                    return;
+                }
+            }
+        };
+        if (hashMove) promote(*hashMove);
+        promote(_killers[ply][0]);
+        promote(_killers[ply][1]);
+    }
+
+    //
+    // principal variation search over the frames. true once the root has its score, false
+    // when the slice ran out (the walk resumes from here) or the search was aborted (the board
+    // is put back first)
+    //
+    bool run(int &rootScore)
+    {
+        P &position = *_position;
+        if (_aborted) {
+            unwind(position);
+            return false;
+        }
+        while (true) {
+            Frame &frame = _frames[_ply];
+            int score;
+            if (!_returning) {
+                // the node a slice stopped in front of was counted before it stopped
+                if (_resuming) {
+                    _resuming = false;
+                } else if ((++_nodes & 255) == 0 && (timeUp() || sliceOver())) {
+                    if (_aborted) {
+                        unwind(position);
+                    } else {
+                        _resuming = true;
+                    }
+                    return false;
+                }
+                if (!enter(position, frame, score)) {
+                    playMove(position, frame);
+                    continue;
+                }
+            } else {
+                _returning = false;
+                score = -_childScore;
+                // prove the move is no better than what we have with a null window, re-search if it is
+                if (frame.stage == Stage::NullWindow && score > frame.alpha && score < frame.beta) {
+                    frame.stage = Stage::ReSearch;
+                    openChild(frame, -frame.beta, -frame.alpha);
+                    continue;
+                }
+                position.unmakeMove(frame.move);
+                if (!finishMove(position, frame, score)) {
+                    continue;
+                }
+                score = frame.best;
+            }
+
+            // this node is done, hand its score up
+            if (_ply == 0) {
+                rootScore = score;
+                return true;
+            }
+            _ply--;
+            _returning = true;
+            _childScore = score;
+        }
+    }
+
+    // the checks on arriving at a node. true if they settle its score, otherwise its moves are ready
+    bool enter(P &position, Frame &frame, int &score)
+    {
+        const int ply = _ply;
+        int terminalScore;
+        if (position.isTerminal(terminalScore)) {
+            score = terminalScore >= SEARCH_WIN ? terminalScore - ply : terminalScore <= -SEARCH_WIN ? terminalScore + ply : terminalScore;
+            return true;
+        }
+        if (frame.depth <= 0 || ply >= SEARCH_MAX_PLY - 1) {
+            score = position.evaluate();
+            return true;
+        }
+
+        frame.key = position.hash();
+        const Move *hashMove = nullptr;
+        if (const auto *entry = _table.probe(frame.key)) {
+            _ttHits++;
+            hashMove = &entry->move;
+            if (ply > 0 && entry->depth >= frame.depth) {
+                score = fromTable(entry->score, ply);
+                if (entry->bound == Table::BoundExact) return true;
+                if (entry->bound == Table::BoundLower && score >= frame.beta) return true;
+                if (entry->bound == Table::BoundUpper && score <= frame.alpha) return true;
+            }
+        }
+
+        frame.moves.clear();
+        position.generateMoves(frame.moves);
+        if (frame.moves.empty()) {
+            score = position.evaluate();
+            return true;
+        }
+        orderMoves(frame.moves, hashMove, ply);
+        frame.originalAlpha = frame.alpha;
+        frame.best = -SEARCH_INFINITY;
+        frame.bestMove = frame.moves[0];
+        frame.index = 0;
+        return false;
+    }
+
+    // make the frame's current move and open its child, the first move gets the full window
+    void playMove(P &position, Frame &frame)
+    {
+        frame.move = frame.moves[frame.index];
+        position.makeMove(frame.move);
+        if (frame.index == 0) {
+            frame.stage = Stage::First;
+            openChild(frame, -frame.beta, -frame.alpha);
+        } else {
+            frame.stage = Stage::NullWindow;
+            openChild(frame, -frame.alpha - 1, -frame.alpha);
+        }
+    }
+
+    void openChild(Frame &frame, int alpha, int beta)
+    {
+        Frame &child = _frames[_ply + 1];
+        child.depth = frame.depth - 1;
+        child.alpha = alpha;
+        child.beta = beta;
+        _ply++;
+    }
+
+    // score is the final one for the frame's move. true when the node is done, otherwise the
+    // next move has been played
+    bool finishMove(P &position, Frame &frame, int score)
+    {
+        const int ply = _ply;
+        if (score > frame.best) {
+            frame.best = score;
+            frame.bestMove = frame.move;
+            if (ply == 0) {
+                _rootMove = frame.move;
+                _rootMoveFound = true;
+            }
+        }
+        if (score > frame.alpha) frame.alpha = score;
+        if (frame.alpha >= frame.beta) {
+            _cutoffs++;
+            if (!(_killers[ply][0] == frame.move)) {
+                _killers[ply][1] = _killers[ply][0];
+                _killers[ply][0] = frame.move;
+            }
+        } else if (++frame.index < frame.moves.count) {
+            playMove(position, frame);
+            return false;
+        }
+
+        typename Table::Bound bound = frame.best <= frame.originalAlpha ? Table::BoundUpper : frame.best >= frame.beta ? Table::BoundLower : Table::BoundExact;
+        _table.store(frame.key, frame.bestMove, toTable(frame.best, ply), frame.depth, bound);
+        return true;
+    }
+
+    // take back the moves of every open node
+    void unwind(P &position)
+    {
+        for (int ply = _ply - 1; ply >= 0; ply--) {
+            position.unmakeMove(_frames[ply].move);
+        }
+        _ply = 0;
+        _returning = false;
+        _resuming = false;
+    }
+
+    Table               _table;
+    std::vector<Frame>  _frames;        // one per ply, SEARCH_MAX_PLY of them
+    P                   *_position = nullptr;
+    SearchLimits        _limits;
+    Result              _result;
+    int                 _depth = 0;     // of the iteration in progress
+    int                 _ply = 0;       // frame being worked on
+    bool                _returning = false;     // the frame's child just finished with _childScore
+    bool                _resuming = false;      // the last slice ended on entering the frame
+    int                 _childScore = 0;
+    bool                _finished = true;
+    std::chrono::steady_clock::rep _sliceEnd = 0;
+    uint64_t            _iterationStart = 0;
+    std::atomic<bool>   _stop;
+    bool                _aborted = false;
+    uint64_t            _nodes = 0;
+    uint64_t            _ttHits = 0;
+    uint64_t            _cutoffs = 0;
+    // steady_clock ticks, atomic so setTimeLimit() can move them while the search runs
+    std::atomic<std::chrono::steady_clock::rep> _deadline;
+    std::atomic<std::chrono::steady_clock::rep> _pendingDeadline;   // 0 when there is none
+    // what stats() hands out, written by the searching thread
+    mutable std::mutex  _statsMutex;
+    SearchStats         _stats;
+    std::chrono::steady_clock::time_point _start;
+    std::atomic<uint64_t> _liveNodes;
+    Move                _killers[SEARCH_MAX_PLY][2];
+    Move                _rootMove{};
+    bool                _rootMoveFound = false;
+};
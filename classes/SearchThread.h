@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Search.h"
+#include "AllocTracker.h"
+#include <atomic>
+#include <limits>
+#include <optional>
+#include <thread>
+
+//
+// runs an engine's search on a worker thread so a frame never waits for the AI
+//
+// the game hands over a copy of the position and checks take() once a frame. a result is
+// only good for the position it was searched for, so the game asks busyWith() first and a
+// board that changed under the search (an undo, a loaded record) simply starts a new one.
+//
+// while the opponent thinks the thread can ponder: search the position after the opponent's
+// most likely reply, taken from the last principal variation, with no time limit. if that reply
+// is played the search simply carries on under the normal limit (a ponder hit), its iterations
+// and table entries kept. any other move cancels it and starts afresh
+//
+// where there is no thread to spare (a single core, the web build) limits.sliceUs makes the
+// search run on the caller's thread instead, sliceUs microseconds per poll(), picking up where
+// the last slice left off. there is no pondering then, the frames have nothing to give it
+//
+// Engine is a Searcher<P>, or anything else with the same search(), begin(), step(), result(),
+// stop(), clearStop(), setTimeLimit() and stats()
+//
+template <typename Engine, typename P>
+class SearchThread
+{
+public:
+    using Move = typename P::Move;
+    using Result = SearchResult<Move>;
+
+    explicit SearchThread(Engine &engine) : _engine(engine), _key(0), _sliceUs(0), _sliced(false), _pondering(false), _done(false) {}
+    ~SearchThread() { cancel(); }
+
+    // search a copy of position, a search that is still running is stopped first
+    void start(const P &position, const SearchLimits &limits)
+    {
+        cancel();
+        _engine.clearStop();
+        _position = position;
+        _key = position.hash();
+        _pondering = false;
+        _done.store(false, std::memory_order_relaxed);
+        _sliceUs = limits.sliceUs;
+        if (_sliceUs > 0) {
+            _engine.begin(*_position, limits);
+            _sliced = true;
+            return;
+        }
+        _thread = std::thread([this, limits] {
+            // allocation scopes belong to a thread, the game's own ones never see the worker
+            ALLOC_SCOPE("AI search");
+            _result = _engine.search(*_position, limits);
+            _done.store(true, std::memory_order_release);
+        });
+    }
+
+    // the result for position once it is ready, call once a frame. a search of some other
+    // position is dropped for a new one, a ponder of this one turns into the real search
+    bool poll(const P &position, const SearchLimits &limits, Result &result)
+    {
+        if (!busyWith(position)) {
+            start(position, limits);
+            return false;
+        }
+        if (_pondering) {
+            _pondering = false;
+            _engine.setTimeLimit(limits.timeMs);
+        }
+        if (_sliced && !_done.load(std::memory_order_relaxed)) {
+            ALLOC_SCOPE("AI search");
+            if (_engine.step(_sliceUs)) {
+                _result = _engine.result();
+                _done.store(true, std::memory_order_relaxed);
+            }
+        }
+        return take(result);
+    }
+
+    // result is what was just played from position. ponders the reply its pv expects, if the
+    // pv goes that far and the game is not over after the move
+    void ponder(const P &position, const Result &result, const SearchLimits &limits)
+    {
+        if (limits.sliceUs > 0 || result.pv.count < 2) {
+            return;
+        }
+        P predicted = position;
+        Move move = result.pv[0];
+        predicted.makeMove(move);
+        int score;
+        if (predicted.isTerminal(score)) {
+            return;
+        }
+        Move reply = result.pv[1];
+        predicted.makeMove(reply);
+
+        SearchLimits unlimited = limits;
+        unlimited.timeMs = std::numeric_limits<int>::max();
+        start(predicted, unlimited);
+        _pondering = true;
+    }
+
+    // a search was started for this position and its result has not been taken
+    bool busyWith(const P &position) const { return (_thread.joinable() || _sliced) && _key == position.hash(); }
+    bool running() const { return (_thread.joinable() || _sliced) && !_done.load(std::memory_order_acquire); }
+
+    // hands over the result once the search is done
+    bool take(Result &result)
+    {
+        if (!(_thread.joinable() || _sliced) || !_done.load(std::memory_order_acquire)) {
+            return false;
+        }
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+        _sliced = false;
+        result = _result;
+        return true;
+    }
+
+    // stop the search and throw its result away
+    void cancel()
+    {
+        if (_thread.joinable()) {
+            _engine.stop();
+            _thread.join();
+        }
+        if (_sliced && !_done.load(std::memory_order_relaxed)) {
+            // the engine notices the stop straight away and puts its board back
+            _engine.stop();
+            _engine.step(_sliceUs);
+        }
+        _sliced = false;
+        _pondering = false;
+    }
+
+    SearchStats stats() const
+    {
+        SearchStats stats = _engine.stats();
+        stats.pondering = _pondering && stats.searching;
+        return stats;
+    }
+
+private:
+    Engine              &_engine;
+    std::optional<P>    _position;      // the worker's own copy
+    uint64_t            _key;
+    int                 _sliceUs;
+    bool                _sliced;        // a search is running in slices on the caller's thread
+    bool                _pondering;     // only touched by the game's thread
+    Result              _result;
+    std::thread         _thread;
+    std::atomic<bool>   _done;
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include "Entity.h"
 #include "../imgui/imgui.h"
+#include "TextureCache.h"
+#include "BoardRenderer.h"
 
 class Sprite : public Entity
 {
@@ -16,11 +18,19 @@ public:
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
-        _highlighted(false)
+        _highlighted(false),
+        _cachedTexture(nullptr)
         { 
             _entityType = EntitySprite;
         };
-    ~Sprite() { if (_retainCount > 0) release(); }
+    // a copy would share the texture reference without holding one
+    Sprite(const Sprite &) = delete;
+    Sprite &operator=(const Sprite &) = delete;
+    ~Sprite()
+    {
+        TextureCache::instance().release(_cachedTexture);
+        if (_retainCount > 0) release();
+    }
     
     // set the texture to use for this sprite
     void setPosition(float x, float y)
@@ -36,6 +46,7 @@ public:
         _location = ImVec2(point.x - _size.x / 2, point.y - _size.y / 2);
     }
     const ImVec2 &getPosition() { return _location; }
+    const ImVec2 &getSize() const { return _size; }
 
     void setSize(float x, float y)
     {
@@ -59,14 +70,13 @@ public:
     float getRotation() { return _rotation; }
     // moveTo
     void moveTo(const ImVec2 &point) { _location = point; }
-    // draw the sprite
-    void paintSprite()
+    // queue the sprite on the board renderer
+    void paintSprite(BoardRenderer &renderer)
     {
-        if (_size.x > 0.0f && _size.y > 0.0f) 
+        // the texture may still be on its way to the gpu
+        if (_cachedTexture && _cachedTexture->id && _size.x > 0.0f && _size.y > 0.0f) 
         {
-            ImGui::SetCursorPos(_location);
-            ImVec4 highlight = _highlighted ? ImVec4(1, 1, 0, 1) : ImVec4(0, 0, 0, 0);
-            ImGui::Image((void*)(intptr_t)_texture, _size, ImVec2(0, 0), ImVec2(1, 1), _color, highlight);
+            renderer.addQuad(_cachedTexture->id, _location, _size, _cachedTexture->uv0, _cachedTexture->uv1, _color, _highlighted);
         }
     }
 	// is the mouse over this position?
@@ -100,10 +110,8 @@ protected:
     ImVec4  _color;
     // the local Z order
     int _localZOrder;
-    // the texture we're going to draw
-    ImTextureID _texture;
     // currently highlighted
    	bool	_highlighted;
-    // private platform specific texture loading
-    ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+    // the texture we're going to draw, a reference into the texture cache
+    TextureCache::Texture *_cachedTexture;
 };
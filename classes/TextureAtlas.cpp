@@ -0,0 +1,158 @@
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "EmbeddedResources.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+// imgui_draw.cpp keeps its rect packer static, so this file gets a private copy as well
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../imgui/imstb_rectpack.h"
+
+// border around each image, filled with copies of its edge pixels
+static const int PADDING = 2;
+static const int MIN_ATLAS_SIZE = 256;
+static const int MAX_ATLAS_SIZE = 4096;
+static const int MAX_WORKERS = 8;
+
+TextureAtlas::~TextureAtlas()
+{
+    joinWorkers();
+}
+
+bool TextureAtlas::begin(const std::string &directory)
+{
+    for (int i = 0; i < EMBEDDED_IMAGE_COUNT; i++) {
+        Image image;
+        image.name = EMBEDDED_IMAGES[i].name;
+        image.embedded = EMBEDDED_IMAGES[i].pixels;
+        image.width = EMBEDDED_IMAGES[i].width;
+        image.height = EMBEDDED_IMAGES[i].height;
+        _images.push_back(image);
+    }
+
+    // the headers give the sizes, nothing is decoded here
+    std::error_code error;
+    std::filesystem::directory_iterator files;
+    if (_images.empty()) {
+        files = std::filesystem::directory_iterator(directory, error);
+    }
+    for (const auto &entry : files) {
+        if (entry.path().extension() != ".png") {
+            continue;
+        }
+        Image image;
+        image.name = entry.path().filename().string();
+        image.path = entry.path().string();
+        if (stbi_info(image.path.c_str(), &image.width, &image.height, NULL)) {
+            _images.push_back(image);
+        } else {
+            std::cout << "Failed to load texture: " << image.path << std::endl;
+        }
+    }
+    if (_images.empty()) {
+        return false;
+    }
+
+    // grow the atlas until everything fits
+    std::vector<stbrp_rect> rects(_images.size());
+    for (size_t i = 0; i < _images.size(); i++) {
+        rects[i].id = (int)i;
+        rects[i].w = _images[i].width + PADDING * 2;
+        rects[i].h = _images[i].height + PADDING * 2;
+    }
+    bool packed = false;
+    for (_size = MIN_ATLAS_SIZE; _size <= MAX_ATLAS_SIZE; _size *= 2) {
+        std::vector<stbrp_node> nodes(_size);
+        stbrp_context context;
+        stbrp_init_target(&context, _size, _size, nodes.data(), (int)nodes.size());
+        if (stbrp_pack_rects(&context, rects.data(), (int)rects.size())) {
+            packed = true;
+            break;
+        }
+    }
+    if (!packed) {
+        _images.clear();
+        return false;
+    }
+
+    for (const stbrp_rect &rect : rects) {
+        Image &image = _images[rect.id];
+        image.x = rect.x + PADDING;
+        image.y = rect.y + PADDING;
+        Region region;
+        region.uv0 = ImVec2((float)image.x / _size, (float)image.y / _size);
+        region.uv1 = ImVec2((float)(image.x + image.width) / _size, (float)(image.y + image.height) / _size);
+        region.size = ImVec2((float)image.width, (float)image.height);
+        _regions[image.name] = region;
+    }
+
+    // every image has its own patch of the atlas, so the workers never write to the same bytes
+    _pixels.assign((size_t)_size * _size * 4, 0);
+    _next = 0;
+    _remaining = (int)_images.size();
+    int workers = std::clamp((int)std::thread::hardware_concurrency(), 1, std::min(MAX_WORKERS, (int)_images.size()));
+    for (int i = 0; i < workers; i++) {
+        _workers.emplace_back(&TextureAtlas::decodeImages, this);
+    }
+    return true;
+}
+
+void TextureAtlas::decodeImages()
+{
+    Tracer::setThreadName("atlas decoder");
+    for (int i = _next++; i < (int)_images.size(); i = _next++) {
+        TRACE_SCOPE("decode image");
+        const Image &image = _images[i];
+        int width = image.width, height = image.height;
+        unsigned char *decoded = image.embedded ? nullptr : stbi_load(image.path.c_str(), &width, &height, NULL, 4);
+        const unsigned char *pixels = image.embedded ? image.embedded : decoded;
+        if (pixels && width == image.width && height == image.height) {
+            for (int y = -PADDING; y < height + PADDING; y++) {
+                int sourceY = std::clamp(y, 0, height - 1);
+                unsigned char *row = &_pixels[((size_t)(image.y + y) * _size + image.x) * 4];
+                for (int x = -PADDING; x < width + PADDING; x++) {
+                    int sourceX = std::clamp(x, 0, width - 1);
+                    std::memcpy(row + x * 4, pixels + ((size_t)sourceY * width + sourceX) * 4, 4);
+                }
+            }
+        } else {
+            std::cout << "Failed to load texture: " << image.path << std::endl;
+        }
+        stbi_image_free(decoded);
+        _remaining.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void TextureAtlas::joinWorkers()
+{
+    for (std::thread &worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+bool TextureAtlas::update()
+{
+    if (_texture != 0 || _workers.empty() || _remaining.load(std::memory_order_acquire) > 0) {
+        return false;
+    }
+    PROFILE_SCOPE("atlas upload");
+    TRACE_SCOPE("atlas upload");
+    joinWorkers();
+    _texture = TextureCache::upload(_pixels.data(), _size, _size);
+    _pixels.clear();
+    _pixels.shrink_to_fit();
+    return _texture != 0;
+}
+
+const TextureAtlas::Region *TextureAtlas::find(const std::string &name) const
+{
+    auto found = _regions.find(name);
+    return found == _regions.end() ? nullptr : &found->second;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "../imgui/imgui.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//
+// one texture holding every image in the resources directory
+//
+// sprites drawn from the atlas all share a texture id, so imgui merges a whole board of them
+// into a single draw command. images are packed with imgui's copy of stb_rect_pack and each
+// one gets a border of its own edge pixels so linear filtering never picks up a neighbour
+//
+// the images normally come pre-decoded from the executable (see EmbeddedResources.h). without
+// them only the png headers are read up front, which is enough to pack the atlas and hand out
+// regions straight away. either way a pool of workers fills in the images in parallel and
+// update(), called once a frame on the render thread, uploads the atlas when they finish
+//
+class TextureAtlas
+{
+public:
+    struct Region
+    {
+        ImVec2  uv0;
+        ImVec2  uv1;
+        ImVec2  size;       // in pixels, the size the image had on its own
+    };
+
+    TextureAtlas() : _texture(0), _size(0), _next(0), _remaining(0) {}
+    ~TextureAtlas();
+
+    // pack the embedded images, or every .png in directory if there are none, and start filling
+    // in the pixels. false if nothing could be packed
+    bool            begin(const std::string &directory);
+    // upload the atlas once decoding is done, true on the frame it happens
+    bool            update();
+
+    const Region    *find(const std::string &name) const;
+    ImTextureID     texture() const { return _texture; }
+    bool            built() const { return _texture != 0; }
+    // decoding or waiting for update() to upload
+    bool            loading() const { return !_workers.empty(); }
+
+private:
+    struct Image
+    {
+        std::string     name;
+        std::string     path;
+        const unsigned char *embedded = nullptr;
+        int             x;
+        int             y;
+        int             width;
+        int             height;
+    };
+
+    void            decodeImages();
+    void            joinWorkers();
+
+    std::unordered_map<std::string, Region> _regions;
+    std::vector<Image>          _images;
+    std::vector<unsigned char>  _pixels;        // filled in by the workers, freed after the upload
+    std::vector<std::thread>    _workers;
+    ImTextureID                 _texture;
+    int                         _size;
+    std::atomic<int>            _next;          // next image for a worker to take
+    std::atomic<int>            _remaining;     // images not decoded yet
+};
@@ -0,0 +1,179 @@
+#include "TextureCache.h"
+#include "Profiler.h"
+#include "Trace.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <iostream>
+#include <filesystem>
+
+static const char *RESOURCE_DIRECTORY = "../resources";
+
+TextureCache &TextureCache::instance()
+{
+    static TextureCache cache;
+    return cache;
+}
+
+bool TextureCache::buildAtlas()
+{
+    return _atlas.begin(RESOURCE_DIRECTORY);
+}
+
+void TextureCache::update()
+{
+    if (_atlas.update()) {
+        for (auto &entry : _textures) {
+            if (entry.second.inAtlas) {
+                entry.second.id = _atlas.texture();
+            }
+        }
+    }
+}
+
+TextureCache::Texture *TextureCache::acquire(const char *filename)
+{
+    auto found = _textures.find(filename);
+    if (found != _textures.end()) {
+        found->second.refs++;
+        return &found->second;
+    }
+
+    if (const TextureAtlas::Region *region = _atlas.find(filename)) {
+        Texture &texture = _textures[filename];
+        texture.name = filename;
+        texture.id = _atlas.texture();
+        texture.size = region->size;
+        texture.uv0 = region->uv0;
+        texture.uv1 = region->uv1;
+        texture.refs = 1;
+        texture.inAtlas = true;
+        return &texture;
+    }
+
+    PROFILE_SCOPE("texture load");
+    TRACE_SCOPE("texture load");
+    int image_width = 0;
+    int image_height = 0;
+    std::filesystem::path resourcePath = std::filesystem::path(RESOURCE_DIRECTORY) / filename;
+    std::string newFilename = resourcePath.string();
+    unsigned char* image_data = stbi_load(newFilename.c_str(), &image_width, &image_height, NULL, 4);
+    if (image_data == NULL) {
+        std::cout << "Failed to load texture: " << newFilename << std::endl;
+        return nullptr;
+    }
+    ImTextureID id = upload(image_data, image_width, image_height);
+    stbi_image_free(image_data);
+    if (id == 0) {
+        return nullptr;
+    }
+
+    Texture &texture = _textures[filename];
+    texture.name = filename;
+    texture.id = id;
+    texture.size = ImVec2((float)image_width, (float)image_height);
+    texture.refs = 1;
+    return &texture;
+}
+
+void TextureCache::release(Texture *texture)
+{
+    if (!texture || --texture->refs > 0) {
+        return;
+    }
+    if (!texture->inAtlas) {
+        destroy(texture->id);
+    }
+    _textures.erase(texture->name);
+}
+
+#ifdef __APPLE__
+#include "../imgui/imgui_impl_opengl3_loader.h"
+
+ImTextureID TextureCache::upload(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create a OpenGL texture identifier
+    GLuint image_texture;
+    glGenTextures(1, &image_texture);
+    glBindTexture(GL_TEXTURE_2D, image_texture);
+
+    // Setup filtering parameters for display
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Upload pixels into texture
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
+
+    return static_cast<ImTextureID>(image_texture);
+}
+
+void TextureCache::destroy(ImTextureID id)
+{
+    GLuint texture = (GLuint)id;
+    glDeleteTextures(1, &texture);
+}
+
+#else
+
+// DirectX
+#include <stdio.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
+#endif
+
+ImTextureID TextureCache::upload(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create texture
+    D3D11_TEXTURE2D_DESC desc;
+    ZeroMemory(&desc, sizeof(desc));
+    desc.Width = image_width;
+    desc.Height = image_height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = 0;
+
+    ID3D11Texture2D *pTexture = NULL;
+    D3D11_SUBRESOURCE_DATA subResource;
+    subResource.pSysMem = image_data;
+    subResource.SysMemPitch = desc.Width * 4;
+    subResource.SysMemSlicePitch = 0;
+
+    // You need to have a valid ID3D11Device* available as g_pd3dDevice
+    extern ID3D11Device* g_pd3dDevice; // Add this line if g_pd3dDevice is defined elsewhere
+
+    HRESULT hr = g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
+    if (FAILED(hr) || !pTexture) {
+        return 0;
+    }
+
+    // Create texture view
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    ZeroMemory(&srvDesc, sizeof(srvDesc));
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = desc.MipLevels;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+
+    ID3D11ShaderResourceView* shaderResourceView = nullptr;
+    hr = g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &shaderResourceView);
+    pTexture->Release();
+
+    if (FAILED(hr) || !shaderResourceView) {
+
+        return 0;
+    }
+    return reinterpret_cast<ImTextureID>(shaderResourceView);
+}
+void TextureCache::destroy(ImTextureID id)
+{
+    ID3D11ShaderResourceView* shaderResourceView = reinterpret_cast<ID3D11ShaderResourceView*>(id);
+    if (shaderResourceView) {
+        shaderResourceView->Release();
+    }
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+#include "../imgui/imgui.h"
+#include "TextureAtlas.h"
+#include <string>
+#include <unordered_map>
+
+//
+// every image under resources/ is decoded and uploaded once and shared by all the sprites
+// that use it. sprites hold a reference while they show a texture, the texture is deleted
+// when the last one lets go
+//
+// images packed into the atlas are handed out as a region of the one atlas texture. the region
+// is known as soon as the atlas is packed, its texture id stays 0 until the atlas is uploaded
+//
+class TextureCache
+{
+public:
+    struct Texture
+    {
+        std::string name;
+        ImTextureID id = 0;
+        ImVec2      size = ImVec2(0, 0);
+        ImVec2      uv0 = ImVec2(0, 0);
+        ImVec2      uv1 = ImVec2(1, 1);
+        int         refs = 0;
+        bool        inAtlas = false;    // the atlas owns the gpu texture
+    };
+
+    static TextureCache &instance();
+
+    // pack everything in resources/ into the atlas and start decoding it in the background
+    bool        buildAtlas();
+    // once a frame on the render thread, uploads whatever has finished decoding
+    void        update();
+    // true until the atlas has been uploaded
+    bool        loading() const { return _atlas.loading(); }
+
+    // the texture for a file in resources/, loaded on first use, nullptr if it can't be loaded
+    Texture     *acquire(const char *filename);
+    void        release(Texture *texture);
+
+    // number of images in use
+    int         size() const { return (int)_textures.size(); }
+
+    // platform specific upload and delete
+    static ImTextureID  upload(const unsigned char *pixels, int width, int height);
+    static void         destroy(ImTextureID id);
+
+private:
+    TextureCache() {}
+
+    std::unordered_map<std::string, Texture> _textures;
+    TextureAtlas    _atlas;
+};
@@ -1,9 +1,12 @@
 #include "TicTacToe.h"
 
+// boards bigger than tic-tac-toe shrink their squares to stay about this wide
+static const float BOARD_PIXELS = 640.0f;
 
-TicTacToe::TicTacToe()
+TicTacToe::TicTacToe(int width, int height, int winLength) : _engine(width, height, winLength), _aiPosition(width, height, winLength), _aiThread(_engine), _width(width), _height(height), _winLength(winLength)
 {
-    _grid = new Grid(3, 3);
+    _grid = new Grid(width, height);
+    _squareSize = std::min(80.0f, BOARD_PIXELS / std::max(width, height));
 }
 
 TicTacToe::~TicTacToe()
@@ -21,15 +24,18 @@ Bit* TicTacToe::PieceForPlayer(const int playerNumber)
     // should possibly be cached from player class?
     bit->LoadTextureFromFile(playerNumber == AI_PLAYER ? "o.png" : "x.png");
     bit->setOwner(getPlayerAt(playerNumber == AI_PLAYER ? 1 : 0));
+    bit->setGameTag(bit->getOwner()->playerNumber() + 1);
+    bit->setSize(_squareSize, _squareSize);
     return bit;
 }
 
 void TicTacToe::setUpBoard()
 {
     setNumberOfPlayers(2);
-    _gameOptions.rowX = 3;
-    _gameOptions.rowY = 3;
-    _grid->initializeSquares(80, "square.png");
+    _gameOptions.rowX = _width;
+    _gameOptions.rowY = _height;
+    _grid->initializeSquares(_squareSize, "square.png");
+    _gameOptions.AITimeLimitMs = 200;
 
     if (gameHasAI()) {
         setAIPlayer(AI_PLAYER);
@@ -50,6 +56,7 @@ bool TicTacToe::actionForEmptyHolder(BitHolder &holder)
     if (bit) {
         bit->setPosition(holder.getPosition());
         holder.setBit(bit);
+        recordMove(GameMove::drop(holderIndex(holder), bit->gameTag(), getCurrentPlayer()->playerNumber()));
         endTurn();
         return true;
     }   
@@ -73,6 +80,7 @@ bool TicTacToe::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
 //
 void TicTacToe::stopGame()
 {
+    stopAI();
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
@@ -83,23 +91,40 @@ void TicTacToe::stopGame()
 //
 Player* TicTacToe::ownerAt(int index ) const
 {
-    auto square = _grid->getSquare(index % 3, index / 3);
+    auto square = _grid->getSquare(index % _width, index / _width);
     if (!square || !square->bit()) {
         return nullptr;
     }
     return square->bit()->getOwner();
 }
 
+//
+// look for _winLength in a row starting from every owned square, walking right, down and along both diagonals
+//
 Player* TicTacToe::checkForWinner()
 {
-    static const int kWinningTriples[8][3] =  { {0,1,2}, {3,4,5}, {6,7,8},  // rows
-                                                {0,3,6}, {1,4,7}, {2,5,8},  // cols
-                                                {0,4,8}, {2,4,6} };         // diagonals
-    for( int i=0; i<8; i++ ) {
-        const int *triple = kWinningTriples[i];
-        Player *player = ownerAt(triple[0]);
-        if( player && player == ownerAt(triple[1]) && player == ownerAt(triple[2]) )
-            return player;
+    static const int kDirections[4][2] = { {1,0}, {0,1}, {1,1}, {-1,1} };
+    for (int y = 0; y < _height; y++) {
+        for (int x = 0; x < _width; x++) {
+            Player *player = ownerAt(y * _width + x);
+            if (!player) {
+                continue;
+            }
+            for (int d = 0; d < 4; d++) {
+                int k = 1;
+                while (k < _winLength) {
+                    int nx = x + kDirections[d][0] * k;
+                    int ny = y + kDirections[d][1] * k;
+                    if (!_grid->isValid(nx, ny) || ownerAt(ny * _width + nx) != player) {
+                        break;
+                    }
+                    k++;
+                }
+                if (k == _winLength) {
+                    return player;
+                }
+            }
+        }
     }
     return nullptr;
 }
@@ -121,7 +146,7 @@ bool TicTacToe::checkForDraw()
 //
 std::string TicTacToe::initialStateString()
 {
-    return "000000000";
+    return std::string(_width * _height, '0');
 }
 
 //
@@ -130,11 +155,11 @@ std::string TicTacToe::initialStateString()
 //
 std::string TicTacToe::stateString()
 {
-    std::string s = "000000000";
+    std::string s = initialStateString();
     _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
         Bit *bit = square->bit();
         if (bit) {
-            s[y * 3 + x] = std::to_string(bit->getOwner()->playerNumber()+1)[0];
+            s[y * _width + x] = std::to_string(bit->getOwner()->playerNumber()+1)[0];
         }
     });
     return s;
@@ -147,7 +172,7 @@ std::string TicTacToe::stateString()
 void TicTacToe::setStateString(const std::string &s)
 {
     _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y*3 + x;
+        int index = y*_width + x;
         int playerNumber = s[index] - '0';
         if (playerNumber) {
             square->setBit( PieceForPlayer(playerNumber-1) );
@@ -163,85 +188,15 @@ void TicTacToe::setStateString(const std::string &s)
 //
 void TicTacToe::updateAI() 
 {
-    int bestVal = -1000;
-    BitHolder* bestMove = nullptr;
-    std::string state = stateString();
-
-    // Traverse all cells, evaluate minimax function for all empty cells
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y * 3 + x;
-        // Check if cell is empty
-        if (state[index] == '0') {
-            // Make the move
-            state[index] = '2';
-            int moveVal = -negamax(state, 0, HUMAN_PLAYER);
-            // Undo the move
-            state[index] = '0';
-            // If the value of the current move is more than the best value, update best
-            if (moveVal > bestVal) {
-                bestMove = square;
-                bestVal = moveVal;
-            }
-        }
-    });
-
-
-    // Make the best move
-    if(bestMove) {
-        if (actionForEmptyHolder(*bestMove)) {
+    _aiPosition.load(snapshot());
+    _aiPosition.setSideToMove(getCurrentPlayer()->playerNumber() + 1);
+    // the search runs on its own thread, this is called every frame until its result is in
+    MNKEngine::Result result;
+    if (_aiThread.poll(_aiPosition, aiSearchLimits(), result) && result.hasMove) {
+        int cell = result.bestMove.cell;
+        actionForEmptyHolder(*_grid->getSquare(cell % _width, cell / _width));
+        if (shouldPonder()) {
+            _aiThread.ponder(_aiPosition, result, aiSearchLimits());
         }
     }
 }
-
-bool isAIBoardFull(const std::string& state) {
-    return state.find('0') == std::string::npos;
-}
-
-int evaluateAIBoard(const std::string& state) {
-    static const int kWinningTriples[8][3] =  { {0,1,2}, {3,4,5}, {6,7,8},  // rows
-                                                {0,3,6}, {1,4,7}, {2,5,8},  // cols
-                                                {0,4,8}, {2,4,6} };         // diagonals
-    for( int i=0; i<8; i++ ) {
-        const int *triple = kWinningTriples[i];
-        char first = state[triple[0]];
-        if( first != '0' && first == state[triple[1]] && first == state[triple[2]] ) {
-            return 10;   // someone won, negamax will handle who
-        }
-    }
-    return 0; // No winner
-}
-
-//
-// player is the current player's number (AI or human)
-//
-int TicTacToe::negamax(std::string& state, int depth, int playerColor) 
-{
-    int score = evaluateAIBoard(state);
-
-    // Check if AI wins, human wins, or draw
-    if(score) { 
-        // A winning state is a loss for the player whose turn it is.
-        // The previous player made the winning move.
-        return -score; 
-    }
-
-    if(isAIBoardFull(state)) {
-        return 0; // Draw
-    }
-
-    int bestVal = -1000; // Min value
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            // Check if cell is empty
-            if (state[y * 3 + x] == '0') {
-                // Make the move
-                state[y * 3 + x] = playerColor == HUMAN_PLAYER ? '1' : '2'; // Set the cell to the current player's color
-                bestVal = std::max(bestVal, -negamax(state, depth + 1, -playerColor));
-                // Undo the move for backtracking
-                state[y * 3 + x] = '0';
-            }
-        }
-    }
-
-    return bestVal;
-}
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 #include "Game.h"
+#include "MNKEngine.h"
+#include "SearchThread.h"
 
 //
 // the classic game of tic tac toe
+// the board size and the number in a row needed to win are configurable, so this is
+// really an m,n,k game and bigger variants (see Gomoku) are built on top of it
 //
 
 //
@@ -11,11 +15,12 @@
 class TicTacToe : public Game
 {
 public:
-    TicTacToe();
+    TicTacToe(int width = 3, int height = 3, int winLength = 3);
     ~TicTacToe();
 
     // set up the board
     void        setUpBoard() override;
+    const char *gameName() const override { return "TicTacToe"; }
 
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
@@ -26,15 +31,24 @@ public:
     bool        canBitMoveFrom(Bit &bit, BitHolder &src) override;
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
     void        stopGame() override;
+    Bit *       pieceForTag(int tag) override { return PieceForPlayer(tag == 1 ? HUMAN_PLAYER : AI_PLAYER); }
 
 	void        updateAI() override;
+    void        stopAI() override { _aiThread.cancel(); }
+    bool        searchStats(SearchStats &stats) const override { stats = _aiThread.stats(); return true; }
     bool        gameHasAI() override { return true; }
     Grid* getGrid() override { return _grid; }
-private:
+protected:
     Bit *       PieceForPlayer(const int playerNumber);
     Player*     ownerAt(int index ) const;
-    int         negamax(std::string& state, int depth, int playerColor);
 
     Grid*       _grid;
+    MNKEngine   _engine;
+    MNKPosition _aiPosition;        // scratch board the AI's position is loaded into
+    SearchThread<MNKEngine, MNKPosition> _aiThread;
+    int         _width;
+    int         _height;
+    int         _winLength;
+    float       _squareSize;
 };
 
@@ -0,0 +1,169 @@
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// events kept per thread, the oldest are overwritten
+static const uint64_t BUFFER_EVENTS = 1 << 15;
+
+struct TraceEvent
+{
+    const char  *name;
+    const char  *argName;
+    int64_t     arg;
+    uint64_t    start;
+    uint64_t    end;
+};
+
+//
+// one ring buffer slot, a sequence lock around an event. sequence is 2 * n + 1 while event n
+// is being written into it and 2 * n + 2 once it is complete, so a reader that sees the same
+// even value before and after its copy knows the owning thread did not touch the slot in
+// between. the fields are relaxed atomics only so that a torn copy is not a data race, on the
+// usual hardware they are plain loads and stores
+//
+struct TraceSlot
+{
+    std::atomic<uint64_t>       sequence{ 0 };
+    std::atomic<const char *>   name{ nullptr };
+    std::atomic<const char *>   argName{ nullptr };
+    std::atomic<int64_t>        arg{ 0 };
+    std::atomic<uint64_t>       start{ 0 };
+    std::atomic<uint64_t>       end{ 0 };
+
+    void store(uint64_t index, const TraceEvent &event)
+    {
+        sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        name.store(event.name, std::memory_order_relaxed);
+        argName.store(event.argName, std::memory_order_relaxed);
+        arg.store(event.arg, std::memory_order_relaxed);
+        start.store(event.start, std::memory_order_relaxed);
+        end.store(event.end, std::memory_order_relaxed);
+        sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    // false when event index is not what the slot holds, or it changed during the copy
+    bool load(uint64_t index, TraceEvent &event) const
+    {
+        if (sequence.load(std::memory_order_acquire) != 2 * index + 2) {
+            return false;
+        }
+        event.name = name.load(std::memory_order_relaxed);
+        event.argName = argName.load(std::memory_order_relaxed);
+        event.arg = arg.load(std::memory_order_relaxed);
+        event.start = start.load(std::memory_order_relaxed);
+        event.end = end.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == 2 * index + 2;
+    }
+};
+
+struct TraceBuffer
+{
+    int                     id;
+    std::atomic<const char *> threadName;
+    std::atomic<uint64_t>   written;        // events ever recorded, only the owning thread adds to it
+    std::unique_ptr<TraceSlot[]> slots;
+};
+
+std::atomic<bool> Tracer::_enabled(false);
+
+static std::mutex bufferListMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> bufferList;
+static std::atomic<uint64_t> sessionStart(0);
+static thread_local TraceBuffer *threadBuffer = nullptr;
+static thread_local const char *threadName = nullptr;
+
+//
+// a thread's buffer is made on its first event and outlives the thread, so a finished worker
+// still shows up in the trace
+//
+static TraceBuffer *currentBuffer()
+{
+    if (!threadBuffer) {
+        auto buffer = std::make_unique<TraceBuffer>();
+        buffer->threadName.store(threadName, std::memory_order_relaxed);
+        buffer->written.store(0, std::memory_order_relaxed);
+        buffer->slots = std::make_unique<TraceSlot[]>(BUFFER_EVENTS);
+        std::lock_guard<std::mutex> lock(bufferListMutex);
+        buffer->id = (int)bufferList.size() + 1;
+        threadBuffer = buffer.get();
+        bufferList.push_back(std::move(buffer));
+    }
+    return threadBuffer;
+}
+
+uint64_t Tracer::now()
+{
+    static const auto base = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - base).count();
+}
+
+void Tracer::start()
+{
+    sessionStart.store(now(), std::memory_order_relaxed);
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop()
+{
+    _enabled.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const char *name)
+{
+    threadName = name;
+    if (threadBuffer) {
+        threadBuffer->threadName.store(name, std::memory_order_relaxed);
+    }
+}
+
+void Tracer::record(const char *name, uint64_t start, uint64_t end, const char *argName, int64_t arg)
+{
+    TraceBuffer *buffer = currentBuffer();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    buffer->slots[index % BUFFER_EVENTS].store(index, { name, argName, arg, start, end });
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::write(const std::string &path)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    const uint64_t since = sessionStart.load(std::memory_order_relaxed);
+    bool first = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    std::lock_guard<std::mutex> lock(bufferListMutex);
+    for (const auto &buffer : bufferList) {
+        if (const char *name = buffer->threadName.load(std::memory_order_relaxed)) {
+            fprintf(file, "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",", buffer->id, name);
+            first = false;
+        }
+        // threads that are still tracing (a scope that began before stop(), a worker) may lap
+        // the reader, the slots they overwrite meanwhile fail their sequence check and are left out
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        for (uint64_t i = written > BUFFER_EVENTS ? written - BUFFER_EVENTS : 0; i < written; i++) {
+            TraceEvent event;
+            if (!buffer->slots[i % BUFFER_EVENTS].load(i, event) || event.start < since) {
+                continue;
+            }
+            // complete events, microseconds
+            fprintf(file, "%s\n{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                    first ? "" : ",", event.name, buffer->id, event.start / 1000.0, (event.end - event.start) / 1000.0);
+            if (event.argName) {
+                fprintf(file, ",\"args\":{\"%s\":%lld}", event.argName, (long long)event.arg);
+            }
+            fprintf(file, "}");
+            first = false;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+//
+// a timeline of what every thread is doing, written in the chrome trace event format for
+// chrome://tracing or ui.perfetto.dev
+//
+// TRACE_SCOPE("name") records one event covering the rest of the block, TRACE_SCOPE_VALUE
+// attaches a number to it (the depth of a search iteration, say). each thread writes into a
+// ring buffer of its own without taking a lock, the buffers are only read by write(), which
+// checks a sequence number on every slot and drops any that are rewritten as it reads them.
+// while tracing is off a scope costs the one test of enabled()
+//
+// names are kept as pointers, so they must be string literals
+//
+class Tracer
+{
+public:
+    static bool     enabled() { return _enabled.load(std::memory_order_relaxed); }
+    // events from before start() are left out of the next write()
+    static void     start();
+    static void     stop();
+    static bool     write(const std::string &path);
+
+    // shown against the calling thread's events
+    static void     setThreadName(const char *name);
+
+    static uint64_t now();
+    static void     record(const char *name, uint64_t start, uint64_t end, const char *argName, int64_t arg);
+
+private:
+    static std::atomic<bool>    _enabled;
+};
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name, const char *argName = nullptr, int64_t arg = 0) :
+        _name(Tracer::enabled() ? name : nullptr), _argName(argName), _arg(arg), _start(0)
+    {
+        if (_name) {
+            _start = Tracer::now();
+        }
+    }
+    ~TraceScope()
+    {
+        if (_name) {
+            Tracer::record(_name, _start, Tracer::now(), _argName, _arg);
+        }
+    }
+
+private:
+    const char  *_name;
+    const char  *_argName;
+    int64_t     _arg;
+    uint64_t    _start;
+};
+
+#define TRACE_JOIN2(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN2(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_JOIN(traceScope, __LINE__)(name)
+#define TRACE_SCOPE_VALUE(name, argName, value) TraceScope TRACE_JOIN(traceScope, __LINE__)(name, argName, (int64_t)(value))
@@ -0,0 +1,76 @@
+#include "TurnHistory.h"
+#include <algorithm>
+
+TurnHistory::TurnHistory() : _turnStart(0), _cursor(0)
+{
+    _moves.reserve(256);
+    _keyframes.reserve(8);
+}
+
+void TurnHistory::reset(const BoardSnapshot &start)
+{
+    _moves.clear();
+    _keyframes.clear();
+    _keyframes.push_back(start);
+    _turnStart = 0;
+    _cursor = 0;
+}
+
+void TurnHistory::push(const GameMove &move)
+{
+    // a new move after an undo replaces the moves that were taken back
+    if (_cursor < size()) {
+        _moves.resize(_cursor);
+        _keyframes.resize(std::min((int)_keyframes.size(), _cursor / KEYFRAME_INTERVAL + 1));
+    }
+    // keyframes are rolled forward from the previous one once the move before them can no longer change,
+    // closeTurn() still flags the newest move so it waits for the next push
+    if (size() > 0 && size() % KEYFRAME_INTERVAL == 0 && (int)_keyframes.size() == size() / KEYFRAME_INTERVAL) {
+        _keyframes.push_back(positionAt(size()));
+    }
+    _moves.push_back(move);
+    _cursor = size();
+}
+
+void TurnHistory::closeTurn()
+{
+    if (_cursor > _turnStart) {
+        _moves[_cursor - 1].flags |= GameMove::EndsTurn;
+    }
+    _turnStart = _cursor;
+}
+
+void TurnHistory::setCursor(int ply)
+{
+    _cursor = std::clamp(ply, 0, size());
+    // the open turn starts after the last finished one
+    _turnStart = turnStartBefore(_cursor + 1);
+}
+
+int TurnHistory::turnStartBefore(int ply) const
+{
+    int start = std::clamp(ply, 1, size() + 1) - 1;
+    while (start > 0 && !_moves[start - 1].endsTurn()) {
+        start--;
+    }
+    return start;
+}
+
+int TurnHistory::turnEndAfter(int ply) const
+{
+    int end = std::clamp(ply, 0, size());
+    while (end < size() && !_moves[end++].endsTurn()) {
+    }
+    return end;
+}
+
+BoardSnapshot TurnHistory::positionAt(int ply) const
+{
+    ply = std::clamp(ply, 0, size());
+    int keyframe = std::min(ply / KEYFRAME_INTERVAL, (int)_keyframes.size() - 1);
+    BoardSnapshot board = _keyframes[keyframe];
+    for (int i = keyframe * KEYFRAME_INTERVAL; i < ply; i++) {
+        applyMove(board, _moves[i]);
+    }
+    return board;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "GameMove.h"
+#include "BoardSnapshot.h"
+#include <vector>
+
+//
+// everything played in the current game
+//
+// moves sit in one contiguous array and every KEYFRAME_INTERVAL moves a full snapshot is kept,
+// so any earlier position is rebuilt from the nearest keyframe plus a few moves.
+// reset() empties the history for a new game but keeps the storage, so once a game of
+// typical length has been played the history stops allocating
+//
+// the cursor is the number of moves currently on the board. undo and redo only move the
+// cursor, pushing a move after an undo throws away everything past it
+//
+class TurnHistory
+{
+public:
+    static const int KEYFRAME_INTERVAL = 32;
+
+    TurnHistory();
+
+    // start a new game from the given board
+    void            reset(const BoardSnapshot &start);
+
+    // add a move at the cursor, the board it is played on must be the one after the previous move
+    void            push(const GameMove &move);
+
+    // mark the last move as finishing the player's turn
+    void            closeTurn();
+    // moves recorded since the last closed turn
+    int             movesThisTurn() const { return _cursor - _turnStart; }
+
+    // undo / redo
+    int             cursor() const { return _cursor; }
+    void            setCursor(int ply);
+    bool            canUndo() const { return _cursor > 0; }
+    bool            canRedo() const { return _cursor < size(); }
+    // first move of the turn holding the move before ply, and one past the last move of the turn starting at ply
+    int             turnStartBefore(int ply) const;
+    int             turnEndAfter(int ply) const;
+
+    int             size() const { return (int)_moves.size(); }
+    bool            empty() const { return _moves.empty(); }
+    const GameMove  &at(int ply) const { return _moves[ply]; }
+    const GameMove  &back() const { return _moves.back(); }
+
+    // the board after the first ply moves
+    BoardSnapshot   positionAt(int ply) const;
+
+private:
+    std::vector<GameMove>       _moves;
+    std::vector<BoardSnapshot>  _keyframes;     // _keyframes[i] is the board after i * KEYFRAME_INTERVAL moves
+    int                         _turnStart;
+    int                         _cursor;
+};
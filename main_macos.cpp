@@ -30,6 +30,12 @@
 #include "../libs/emscripten/emscripten_mainloop_stub.h"
 #endif
 
+// with nothing moving the loop sleeps until there is input, waking now and then anyway so a
+// blinking text cursor still blinks
+static const double IDLE_WAIT_SECONDS = 0.5;
+// imgui can take a couple of frames to settle after an event (hover, layout, popups)
+static const int FRAMES_AFTER_INPUT = 3;
+
 static void glfw_error_callback(int error, const char* description)
 {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
@@ -121,6 +127,7 @@ int main(int, char**)
     bool show_another_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
     ClassGame::GameStartUp();
+    int framesToDraw = FRAMES_AFTER_INPUT;
     
     // Main loop
 #ifdef __EMSCRIPTEN__
@@ -137,7 +144,23 @@ int main(int, char**)
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+#ifndef __EMSCRIPTEN__
+        if (framesToDraw > 0 || ClassGame::WantsRedraw())
+        {
+            glfwPollEvents();
+            framesToDraw = framesToDraw > 0 ? framesToDraw - 1 : 0;
+        }
+        else
+        {
+            // idle, render again only once something happens
+            double idleStart = glfwGetTime();
+            glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+            if (glfwGetTime() - idleStart < IDLE_WAIT_SECONDS)
+                framesToDraw = FRAMES_AFTER_INPUT;
+        }
+#else
         glfwPollEvents();
+#endif
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
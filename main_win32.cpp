@@ -28,6 +28,12 @@ void CreateRenderTarget();
 void CleanupRenderTarget();
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+// with nothing moving the loop sleeps until there is input, waking now and then anyway so a
+// blinking text cursor still blinks
+static const DWORD IDLE_WAIT_MS = 500;
+// imgui can take a couple of frames to settle after an event (hover, layout, popups)
+static const int FRAMES_AFTER_INPUT = 3;
+
 // Main code
 int main(int, char**)
 {
@@ -110,8 +116,19 @@ int main(int, char**)
 
     // Main loop
     bool done = false;
+    int framesToDraw = FRAMES_AFTER_INPUT;
     while (!done)
     {
+        if (framesToDraw > 0 || ClassGame::WantsRedraw())
+        {
+            framesToDraw = framesToDraw > 0 ? framesToDraw - 1 : 0;
+        }
+        else if (::MsgWaitForMultipleObjects(0, nullptr, FALSE, IDLE_WAIT_MS, QS_ALLINPUT) != WAIT_TIMEOUT)
+        {
+            // idle until something happens, then give imgui a few frames
+            framesToDraw = FRAMES_AFTER_INPUT;
+        }
+
         // Poll and handle messages (inputs, window resize, etc.)
         // See the WndProc() function below for our to dispatch events to the Win32 backend.
         MSG msg;
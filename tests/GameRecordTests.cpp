@@ -0,0 +1,265 @@
+//
+// game record round trips for gamecore, run by ctest
+//
+// a game is written with saveGameRecord and read back with GameRecordReader, and the board the
+// reader keeps is compared with TurnHistory::positionAt at every ply, forwards and backwards.
+// then the same bytes are cut short and damaged, and the reader has to stop at the last move
+// it can trust instead of playing anything past the board
+//
+#include "GameRecord.h"
+#include "TurnHistory.h"
+#include <cstdio>
+#include <filesystem>
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static std::string recordPath()
+{
+    return (std::filesystem::temp_directory_path() / "gamecore_record_test.grec").string();
+}
+
+static bool writeFile(const std::string &path, const std::vector<uint8_t> &bytes)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = bytes.empty() || fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return fclose(file) == 0 && ok;
+}
+
+static bool sameMove(const GameMove &a, const GameMove &b)
+{
+    return a.from == b.from && a.to == b.to && a.capture == b.capture && a.piece == b.piece && a.moved == b.moved &&
+           a.captured == b.captured && a.player == b.player && a.flags == b.flags && a.flips == b.flips;
+}
+
+//
+// a made up game on an 8x8 board with every kind of move packet in it: drops, slides (some of
+// them promoting, and turns of more than one action), captures, flips and passes. it runs past
+// a few keyframes so positionAt has to roll forward from them
+//
+static const int WIDTH = 8;
+static const int HEIGHT = 8;
+static const int GAME_PLIES = 70;
+
+static void playGame(GameRecordHeader &header, TurnHistory &history)
+{
+    header.gameName = "Record Test";
+    header.width = WIDTH;
+    header.height = HEIGHT;
+    header.aiPlayers = 2;
+    header.maxDepth = 9;
+    header.timeMs = 1500;
+    header.start = BoardSnapshot(WIDTH * HEIGHT, 2);
+    header.start.set(0, 1);
+    header.start.set(63, 2);
+    history.reset(header.start);
+
+    BoardSnapshot board = header.start;
+    int player = 0;
+    for (int i = 0; i < GAME_PLIES; i++) {
+        const int tag = player + 1;
+        // the first empty cell from a point that moves around the board
+        int empty = (i * 37) % board.cells();
+        while (board.get(empty)) {
+            empty = (empty + 1) % board.cells();
+        }
+        int own = -1, theirs = -1;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.get(cell) == tag && own < 0) own = cell;
+            if (board.get(cell) && board.get(cell) != tag && theirs < 0) theirs = cell;
+        }
+
+        GameMove move;
+        bool endsTurn = true;
+        if (i % 10 == 9) {
+            move = GameMove::pass(player);
+        } else if (i % 7 == 3 && own >= 0) {
+            // every other slide promotes, and a slide is half of a two action turn
+            move = GameMove::slide(own, empty, tag, i % 14 == 3 ? 3 : tag, player);
+            endsTurn = false;
+        } else if (i % 11 == 5 && theirs >= 0) {
+            move = GameMove::drop(empty, tag, player);
+            move.capture = (uint16_t)theirs;
+            move.captured = (uint8_t)board.get(theirs);
+        } else if (i % 13 == 6 && theirs >= 0) {
+            move = GameMove::drop(empty, tag, player);
+            move.flips = 1ull << theirs;
+            move.captured = (uint8_t)board.get(theirs);
+        } else {
+            move = GameMove::drop(empty, tag, player);
+        }
+        history.push(move);
+        if (endsTurn) {
+            history.closeTurn();
+            player = 1 - player;
+        }
+        applyMove(board, history.back());
+    }
+}
+
+static void checkRoundTrip(const GameRecordHeader &header, const TurnHistory &history)
+{
+    check(saveGameRecord(recordPath(), header, history), "record is saved");
+
+    GameRecordReader reader;
+    GameRecordHeader read;
+    check(reader.open(recordPath()), "record opens");
+    check(reader.nextGame(read), "header reads back");
+    check(read.gameName == header.gameName && read.width == header.width && read.height == header.height &&
+          read.aiPlayers == header.aiPlayers && read.maxDepth == header.maxDepth && read.timeMs == header.timeMs,
+          "header fields survive");
+    check(read.start == header.start, "start board survives");
+
+    std::vector<GameMove> moves;
+    GameMove move;
+    while (reader.nextMove(move)) {
+        moves.push_back(move);
+        const int ply = (int)moves.size();
+        check(ply <= history.size() && sameMove(move, history.at(ply - 1)), "move survives");
+        check(reader.ply() == ply, "reader counts plies");
+        check(reader.board() == history.positionAt(ply), "reader board matches the history going forwards");
+    }
+    check((int)moves.size() == history.size(), "every move reads back");
+    check(!reader.nextGame(read), "nothing after the only record");
+
+    // and scrub back to the start, taking the moves back one at a time
+    BoardSnapshot board = reader.board();
+    for (int ply = (int)moves.size(); ply > 0; ply--) {
+        unapplyMove(board, moves[ply - 1]);
+        check(board == history.positionAt(ply - 1), "board matches the history going backwards");
+    }
+}
+
+//
+// every prefix of a record, as a torn journal would leave it. the reader may only play the
+// moves it has in full
+//
+static void checkTruncated(const GameRecordHeader &header, const TurnHistory &history)
+{
+    std::vector<uint8_t> bytes;
+    encodeRecordHeader(bytes, header);
+    const size_t headerSize = bytes.size();
+    for (int i = 0; i < history.size(); i++) {
+        encodeRecordMove(bytes, history.at(i));
+    }
+
+    bool allGood = true;
+    for (size_t length = 0; length < bytes.size(); length++) {
+        writeFile(recordPath(), std::vector<uint8_t>(bytes.begin(), bytes.begin() + length));
+        GameRecordReader reader;
+        GameRecordHeader read;
+        reader.open(recordPath());
+        if (!reader.nextGame(read)) {
+            allGood = allGood && length < headerSize;
+            continue;
+        }
+        GameMove move;
+        while (reader.nextMove(move)) {
+        }
+        allGood = allGood && length >= headerSize && reader.ply() < history.size() &&
+                  reader.board() == history.positionAt(reader.ply());
+    }
+    check(allGood, "a cut short record stops at its last whole move");
+}
+
+//
+// moves and headers that do not fit the board are refused, not played
+//
+static int readBack(const std::vector<uint8_t> &bytes, bool &headerRead)
+{
+    writeFile(recordPath(), bytes);
+    GameRecordReader reader;
+    GameRecordHeader header;
+    reader.open(recordPath());
+    headerRead = reader.nextGame(header);
+    GameMove move;
+    while (headerRead && reader.nextMove(move)) {
+    }
+    return reader.ply();
+}
+
+static void checkOutOfRange()
+{
+    // tic-tac-toe, so a flip past the ninth cell is off the board
+    GameRecordHeader header;
+    header.gameName = "TicTacToe";
+    header.width = 3;
+    header.height = 3;
+    header.start = BoardSnapshot(9, 2);
+
+    GameMove flips = GameMove::drop(4, 1, 0);
+    flips.flips = 1ull << 9;
+    GameMove capture = GameMove::drop(4, 1, 0);
+    capture.capture = 9;
+    const GameMove bad[] = { GameMove::drop(9, 1, 0), GameMove::drop(60000, 1, 0), GameMove::slide(9, 4, 1, 1, 0), capture, flips };
+    for (const GameMove &move : bad) {
+        std::vector<uint8_t> bytes;
+        encodeRecordHeader(bytes, header);
+        encodeRecordMove(bytes, GameMove::drop(0, 1, 0));
+        encodeRecordMove(bytes, move);
+        encodeRecordMove(bytes, GameMove::drop(1, 2, 1));
+        bool headerRead;
+        check(readBack(bytes, headerRead) == 1 && headerRead, "a move off the board ends the record");
+    }
+
+    // the header is the magic, version, name length and name, then width and height, all one
+    // byte each here, and bitsPerCell
+    std::vector<uint8_t> bytes;
+    encodeRecordHeader(bytes, header);
+    const size_t bitsPerCellAt = 4 + 1 + 1 + header.gameName.size() + 2;
+    check(bytes[bitsPerCellAt] == 2, "bitsPerCell is where the test expects");
+    bool headerRead;
+    for (uint8_t bits : { 0, 3, 8 }) {
+        std::vector<uint8_t> bad = bytes;
+        bad[bitsPerCellAt] = bits;
+        readBack(bad, headerRead);
+        check(!headerRead, "a header with a bad bitsPerCell is refused");
+    }
+
+    // then aiPlayers, maxDepth and timeMs at one byte each and the cell count
+    const size_t cellsAt = bitsPerCellAt + 4;
+    check(bytes[cellsAt] == 9, "the cell count is where the test expects");
+    std::vector<uint8_t> noCells = bytes;
+    noCells[cellsAt] = 0;
+    readBack(noCells, headerRead);
+    check(!headerRead, "a header with no cells is refused");
+
+    // a board one cell bigger than a snapshot holds, which needs a two byte count
+    header.start = BoardSnapshot(BoardSnapshot::CAPACITY_BITS / 4, 4);
+    std::vector<uint8_t> full;
+    encodeRecordHeader(full, header);
+    readBack(full, headerRead);
+    check(headerRead, "a board that fills a snapshot is read");
+    check(full[bitsPerCellAt] == 4 && full[cellsAt] == (uint8_t)(0x80 | (BoardSnapshot::CAPACITY_BITS / 4)), "the cell count is two bytes");
+    full[cellsAt]++;
+    readBack(full, headerRead);
+    check(!headerRead, "a board too big for a snapshot is refused");
+}
+
+int main()
+{
+    GameRecordHeader header;
+    TurnHistory history;
+    playGame(header, history);
+    checkRoundTrip(header, history);
+    checkTruncated(header, history);
+    checkOutOfRange();
+    std::filesystem::remove(recordPath());
+
+    if (failures) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
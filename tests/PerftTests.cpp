@@ -0,0 +1,115 @@
+//
+// move generator checks for gamecore, run by ctest
+//
+// perft counts every line of play to a fixed depth and compares the totals with the published
+// ones, which catches a missing or extra move anywhere in the tree. every makeMove on the way
+// is undone and the hash compared with the one from before, so a move that does not put the
+// board back fails here rather than as a strange search result
+//
+#include "CheckersPosition.h"
+#include "OthelloPosition.h"
+#include <cstdio>
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+template <SearchPosition P>
+static uint64_t perft(P &position, int depth, bool &roundTrips)
+{
+    if (depth == 0) {
+        return 1;
+    }
+    MoveList<typename P::Move, P::MAX_MOVES> moves;
+    position.generateMoves(moves);
+    if (depth == 1) {
+        return (uint64_t)moves.count;
+    }
+    const uint64_t before = position.hash();
+    uint64_t nodes = 0;
+    for (typename P::Move move : moves) {
+        position.makeMove(move);
+        nodes += perft(position, depth - 1, roundTrips);
+        position.unmakeMove(move);
+        roundTrips = roundTrips && position.hash() == before;
+    }
+    return nodes;
+}
+
+template <SearchPosition P>
+static void checkPerft(const char *name, P position, const uint64_t *expected, int depths)
+{
+    for (int depth = 1; depth <= depths; depth++) {
+        bool roundTrips = true;
+        const uint64_t nodes = perft(position, depth, roundTrips);
+        std::printf("%s perft %d: %llu\n", name, depth, (unsigned long long)nodes);
+        check(nodes == expected[depth - 1], "perft count");
+        check(roundTrips, "unmakeMove puts the hash back");
+    }
+}
+
+//
+// a king that jumps round a square of four men lands back where it started
+//
+static void checkKingLoop()
+{
+    CheckersPosition position;
+    position.setPiece(10, 1, true);
+    for (int square : { 19, 35, 33, 17 }) {
+        position.setPiece(square, 2, false);
+    }
+    position.setSideToMove(1);
+    const uint64_t before = position.hash();
+
+    MoveList<CheckersPosition::Move, CheckersPosition::MAX_MOVES> moves;
+    position.generateMoves(moves);
+    bool found = false;
+    for (CheckersPosition::Move move : moves) {
+        if (move.from != move.to) {
+            continue;
+        }
+        found = true;
+        position.makeMove(move);
+        check(position.pieceCount(1) == 1 && position.pieceCount(2) == 0, "king loop takes all four men");
+        int score;
+        check(position.isTerminal(score), "king loop leaves yellow with nothing");
+        position.unmakeMove(move);
+        check(position.hash() == before, "king loop unmakes");
+        check(position.pieceCount(1) == 1 && position.pieceCount(2) == 4, "king loop puts the men back");
+    }
+    check(found, "king loop is generated");
+}
+
+int main()
+{
+    // published totals for english draughts and othello from the opening position
+    static const uint64_t CHECKERS[] = { 7, 49, 302, 1469, 7361, 36768, 179740, 845931 };
+    static const uint64_t OTHELLO[] = { 4, 12, 56, 244, 1396, 8200, 55092 };
+
+    CheckersPosition checkers;
+    checkers.setUpStart();
+    checkPerft("checkers", checkers, CHECKERS, 8);
+
+    OthelloPosition othello;
+    othello.setStone(3, 3, 2);
+    othello.setStone(4, 4, 2);
+    othello.setStone(4, 3, 1);
+    othello.setStone(3, 4, 1);
+    othello.setSideToMove(1);
+    checkPerft("othello", othello, OTHELLO, 7);
+
+    checkKingLoop();
+
+    if (failures) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
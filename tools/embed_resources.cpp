@@ -0,0 +1,64 @@
+//
+// build step: decode png files and write them out as a C++ source of raw RGBA arrays
+//
+//   embed_resources <output.cpp> <image.png>...
+//
+#define STB_IMAGE_IMPLEMENTATION
+#include "../classes/stb_image.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct Decoded
+{
+    std::string name;
+    int         width;
+    int         height;
+};
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: embed_resources <output.cpp> <image.png>...\n");
+        return 1;
+    }
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        fprintf(stderr, "embed_resources: can't write %s\n", argv[1]);
+        return 1;
+    }
+    fprintf(out, "// generated by tools/embed_resources, do not edit\n");
+    fprintf(out, "#include \"EmbeddedResources.h\"\n\n");
+
+    std::vector<Decoded> images;
+    for (int i = 2; i < argc; i++) {
+        int width, height;
+        unsigned char *pixels = stbi_load(argv[i], &width, &height, NULL, 4);
+        if (!pixels) {
+            fprintf(stderr, "embed_resources: can't decode %s\n", argv[i]);
+            fclose(out);
+            return 1;
+        }
+        std::string path = argv[i];
+        size_t slash = path.find_last_of("/\\");
+        images.push_back({ slash == std::string::npos ? path : path.substr(slash + 1), width, height });
+
+        fprintf(out, "static const unsigned char IMAGE_%d[] = {", (int)images.size() - 1);
+        size_t bytes = (size_t)width * height * 4;
+        for (size_t b = 0; b < bytes; b++) {
+            fprintf(out, b % 24 == 0 ? "\n    %u," : "%u,", pixels[b]);
+        }
+        fprintf(out, "\n};\n\n");
+        stbi_image_free(pixels);
+    }
+
+    fprintf(out, "const EmbeddedImage EMBEDDED_IMAGES[] = {\n");
+    for (size_t i = 0; i < images.size(); i++) {
+        fprintf(out, "    { \"%s\", %d, %d, IMAGE_%d },\n", images[i].name.c_str(), images[i].width, images[i].height, (int)i);
+    }
+    if (images.empty()) {
+        fprintf(out, "    { \"\", 0, 0, nullptr },\n");
+    }
+    fprintf(out, "};\n\nconst int EMBEDDED_IMAGE_COUNT = %d;\n", (int)images.size());
+    return fclose(out) == 0 ? 0 : 1;
+}